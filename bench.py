@@ -0,0 +1,300 @@
+"bench.py"
+#Used to benchmark the module's per-frame CPU cost. Runs headless, so no window is needed.
+
+import time;
+import statistics;
+import numpy as np;
+import glm;
+import gl;
+
+
+######## ANSI COLOURS ########
+
+class Colours:
+	ERROR:str 		= "\033[1;31m"; #Red
+	SUCCESS:str		= "\033[1;32m"; #Green
+	WARNING:str 	= "\033[1;33m"; #Yellow
+	MINOR:str 		= "\033[0;34m"; #Dark-grey
+	MAJOR:str 		= "\033[0;36m"; #White
+	VALUE:str 		= "\033[0;35m"; #Purple
+	DEFAULT:str 	= "\033[0;39m"; #Reset
+
+######## ANSI COLOURS ########
+
+
+
+
+
+
+
+
+######## HELPERS ########
+
+
+WARMUP:int = 50;
+FRAMES:int = 1000;
+
+def timeFrames(name:str, frame, frames:int=FRAMES, warmup:int=WARMUP) -> list[float]:
+	#Time each call of frame(), in microseconds.
+	for _ in range(warmup): frame();
+
+	times:list[float] = [];
+	for _ in range(frames):
+		start:int = time.perf_counter_ns();
+		frame();
+		times.append((time.perf_counter_ns() - start) / 1000.0);
+
+	times.sort();
+	p50:float = times[len(times) // 2];
+	p99:float = times[min(len(times) - 1, (len(times) * 99) // 100)];
+	print(f"{Colours.VALUE}[PY ] {name:<32} mean {statistics.fmean(times):9.2f}us  p50 {p50:9.2f}us  p99 {p99:9.2f}us{Colours.MINOR}");
+	return times;
+
+
+def makeGrid(size:int, order:str) -> tuple[np.ndarray, np.ndarray]:
+	#(size+1)^2 vertices [x, y, z, u, v] facing a default camera, 2*size^2 triangles.
+	#"rows" is the order a generator loop gives, "random" is as bad as it gets.
+	coords:np.ndarray = np.linspace(-1.0, 1.0, size + 1, dtype=np.float32);
+	xs, zs = np.meshgrid(coords, coords);
+	vertices:np.ndarray = np.column_stack([
+		xs.ravel(), np.full(xs.size, 2.0, dtype=np.float32), zs.ravel(), (xs.ravel() + 1.0) / 2.0, (zs.ravel() + 1.0) / 2.0
+	]).astype(np.float32);
+
+	rows, cols = np.meshgrid(np.arange(size), np.arange(size), indexing="ij");
+	corner:np.ndarray = (rows * (size + 1) + cols).ravel();
+	triangles:np.ndarray = np.stack([corner, corner + 1, corner + size + 2, corner, corner + size + 2, corner + size + 1], axis=1).reshape(-1, 3);
+	if (order == "random"):
+		triangles = triangles[np.random.default_rng(0).permutation(len(triangles))];
+	return vertices, triangles.ravel().astype(np.uint32);
+
+
+######## HELPERS ########
+
+
+
+
+
+
+
+
+######## BENCHMARKS ########
+
+
+def benchMeshOptimize(cameraID:int) -> None:
+	#Cost of gl.optimize_mesh() and the cache miss ratio it gets, then GPU time drawing a big grid as given vs optimised.
+	print(f"{Colours.MAJOR}[PY ] Mesh optimisation{Colours.MINOR}");
+	for size in (256, 1024):
+		for order in ("rows", "random"):
+			vertices, indices = makeGrid(size, order);
+			start:int = time.perf_counter_ns();
+			result:dict = gl.optimize_mesh(gl.POS_UV2D, vertices, indices);
+			elapsed:float = (time.perf_counter_ns() - start) / 1e6;
+			print(f"{Colours.VALUE}[PY ] {size}x{size} grid ({order:<6}) ACMR {result['acmr_before']:.3f} -> {result['acmr_after']:.3f} in {elapsed:8.1f}ms{Colours.MINOR}");
+
+	vertices, indices = makeGrid(1024, "random");
+	plainID:int = gl.load_shader(gl.WORLDSPACE, "shaders/worldspace.vert", "shaders/uv.3D.frag");
+	optimisedID:int = gl.load_shader(gl.WORLDSPACE, "shaders/worldspace.vert", "shaders/uv.3D.frag");
+	gl.add_vao(plainID, gl.POS_UV2D, vertices, indices);
+	gl.add_vao(optimisedID, gl.POS_UV2D, vertices, indices, optimize=True);
+	pvm:glm.mat4 = glm.mat4(gl.get_matrix(gl.PERSPECTIVE, cameraID)) * glm.mat4(gl.get_matrix(gl.VIEW, cameraID));
+	for shaderID in (plainID, optimisedID): gl.add_uniform_value(shaderID, "pvmMatrix", pvm);
+
+	gl.configure(gl.WORLDSPACE);
+	gl.enable_gpu_timing(True);
+	for _ in range(100):
+		gl.run(plainID);
+		gl.run(optimisedID);
+		gl.update_window();
+		timings:dict = gl.get_gpu_timings();
+	gl.enable_gpu_timing(False);
+	if (plainID in timings) and (optimisedID in timings):
+		plain:float = timings[plainID]["mean_us"];
+		optimised:float = timings[optimisedID]["mean_us"];
+		print(f"{Colours.VALUE}[PY ] GPU draw of 2M triangles: as given {plain:9.1f}us, optimised {optimised:9.1f}us{Colours.MINOR}");
+		print(f"{Colours.SUCCESS}[PY ] Optimised mesh GPU speedup: {plain / optimised:.2f}x{Colours.MINOR}");
+	else:
+		print(f"{Colours.WARNING}[PY ] No GPU timings available, skipping the draw comparison{Colours.MINOR}");
+
+
+def benchVertexPacking(cameraID:int) -> None:
+	#GPU time drawing the same optimised grid from float32, half and 10:10:10:2 vertices.
+	print(f"{Colours.MAJOR}[PY ] Vertex packing{Colours.MINOR}");
+	vertices, indices = makeGrid(1024, "rows");
+	pvm:glm.mat4 = glm.mat4(gl.get_matrix(gl.PERSPECTIVE, cameraID)) * glm.mat4(gl.get_matrix(gl.VIEW, cameraID));
+	shaderIDs:dict = {};
+	for packing in (gl.PACK_FLOAT, gl.PACK_HALF, gl.PACK_COMPACT):
+		shaderIDs[packing] = gl.load_shader(gl.WORLDSPACE, "shaders/worldspace.vert", "shaders/uv.3D.frag");
+		gl.add_vao(shaderIDs[packing], gl.POS_UV2D, vertices, indices, optimize=True, packing=packing);
+		gl.add_uniform_value(shaderIDs[packing], "pvmMatrix", pvm);
+
+	gl.configure(gl.WORLDSPACE);
+	gl.enable_gpu_timing(True);
+	for _ in range(100):
+		for shaderID in shaderIDs.values(): gl.run(shaderID);
+		gl.update_window();
+		timings:dict = gl.get_gpu_timings();
+	gl.enable_gpu_timing(False);
+	if not all(shaderID in timings for shaderID in shaderIDs.values()):
+		print(f"{Colours.WARNING}[PY ] No GPU timings available, skipping the packing comparison{Colours.MINOR}");
+		return;
+	plain:float = timings[shaderIDs[gl.PACK_FLOAT]]["mean_us"];
+	for packing, shaderID in shaderIDs.items():
+		print(f"{Colours.VALUE}[PY ] GPU draw of 2M triangles from {packing.name:<12}: {timings[shaderID]['mean_us']:9.1f}us ({plain / timings[shaderID]['mean_us']:.2f}x){Colours.MINOR}");
+
+
+def benchMeshDraws(cameraID:int) -> None:
+	#Many small meshes through one shader: a gl.run() each from Python vs one gl.draw().
+	print(f"{Colours.MAJOR}[PY ] Meshes: gl.run() per mesh vs gl.draw(){Colours.MINOR}");
+	shaderID:int = gl.load_shader(gl.WORLDSPACE, "shaders/worldspace.vert", "shaders/uv.3D.frag");
+	pvm:glm.mat4 = glm.mat4(gl.get_matrix(gl.PERSPECTIVE, cameraID)) * glm.mat4(gl.get_matrix(gl.VIEW, cameraID));
+	gl.add_uniform_value(shaderID, "pvmMatrix", pvm);
+	vertices, indices = makeGrid(4, "rows");
+	meshIDs:list[int] = [gl.create_mesh(gl.POS_UV2D, vertices, indices) for _ in range(200)];
+	gl.configure(gl.WORLDSPACE);
+
+	def perMesh() -> None:
+		for meshID in meshIDs: gl.run(shaderID, mesh=meshID);
+		gl.update_window();
+
+	def batched() -> None:
+		gl.draw(shaderID, meshIDs);
+		gl.update_window();
+
+	python:list[float] = timeFrames(f"gl.run(mesh=) x{len(meshIDs)}", perMesh);
+	native:list[float] = timeFrames(f"gl.draw({len(meshIDs)} meshes)", batched);
+	print(f"{Colours.SUCCESS}[PY ] gl.draw() speedup: {statistics.fmean(python) / statistics.fmean(native):.1f}x{Colours.MINOR}");
+	for meshID in meshIDs: gl.delete_mesh(meshID);
+
+
+def benchModelMatrices() -> None:
+	#One gl.get_matrix(gl.MODEL) per object from Python vs the whole batch in one call.
+	print(f"{Colours.MAJOR}[PY ] Model matrices: per-call vs batched{Colours.MINOR}");
+	rng = np.random.default_rng(0);
+	for count in (1_000, 10_000, 100_000):
+		positions:np.ndarray = rng.uniform(-50.0, 50.0, (count, 3)).astype(np.float32);
+		rotations:np.ndarray = rng.uniform(-np.pi, np.pi, (count, 3)).astype(np.float32);
+		scales:np.ndarray = rng.uniform(0.5, 2.0, (count, 3)).astype(np.float32);
+
+		def perCall() -> None:
+			for i in range(count):
+				gl.get_matrix(gl.MODEL, position=positions[i], rotation=rotations[i], scale=scales[i]);
+
+		frames:int = max(5, 200_000 // count);
+		python:list[float] = timeFrames(f"gl.get_matrix() x{count}", perCall, frames // 10 + 1, warmup=1);
+		batched:list[float] = timeFrames(f"gl.get_model_matrices({count})", lambda: gl.get_model_matrices(positions, rotations, scales), frames);
+		print(f"{Colours.SUCCESS}[PY ] Batched speedup at {count}: {statistics.fmean(python) / statistics.fmean(batched):.1f}x{Colours.MINOR}");
+
+	#Same values either way.
+	single:glm.mat4 = glm.mat4(gl.get_matrix(gl.MODEL, position=positions[0], rotation=rotations[0], scale=scales[0]));
+	assert np.allclose(np.array(single, dtype=np.float32), gl.get_model_matrices(positions[:1], rotations[:1], scales[:1])[0], atol=1e-4), "Batched model matrix differs from gl.get_matrix()";
+
+
+def benchCommandList(cameraID:int) -> None:
+	#The same frame as test.py's loop: uniforms, matrices & runs, issued from Python vs replayed natively.
+	print(f"{Colours.MAJOR}[PY ] Command list vs Python loop{Colours.MINOR}");
+	computeID:int = gl.load_shader(gl.COMPUTE, compute="shaders/compute.comp");
+	worldID:int = gl.load_shader(gl.WORLDSPACE, "shaders/worldspace.vert", "shaders/uv.3D.frag");
+	texID:int = gl.create_texture(glm.ivec2(128, 128));
+	gl.add_vao(worldID, gl.POS_UV2D, [
+		-1.0,  1.0,  0.0,	 0.0, 0.0,
+		 1.0,  1.0,  0.0,    1.0, 0.0,
+		 0.0,  1.0,  1.0,    0.0, 1.0,
+	]);
+	objects:int = 8;
+
+	def pythonFrame() -> None:
+		gl.configure(gl.COMPUTE);
+		gl.add_texture(computeID, texID, 0);
+		gl.add_uniform_value(computeID, "time", 0.5);
+		gl.run(computeID, [16, 16, 1]);
+		gl.configure(gl.WORLDSPACE);
+		for i in range(objects):
+			pvm:glm.mat4 = (
+				glm.mat4(gl.get_matrix(gl.PERSPECTIVE, cameraID)) *
+				glm.mat4(gl.get_matrix(gl.VIEW, cameraID)) *
+				glm.mat4(gl.get_matrix(gl.MODEL, position=glm.vec3(i, 0.0, 0.0), scale=glm.vec3(1.0)))
+			);
+			gl.add_uniform_value(worldID, "pvmMatrix", pvm);
+			gl.run(worldID);
+
+	listID:int = gl.create_command_list("bench");
+	gl.record_configure(listID, gl.COMPUTE);
+	gl.record_texture(listID, computeID, texID, 0);
+	gl.record_uniform(listID, computeID, "time", 0.5);
+	gl.record_run(listID, computeID, [16, 16, 1]);
+	gl.record_configure(listID, gl.WORLDSPACE);
+	for i in range(objects):
+		gl.record_matrix_uniform(
+			listID, worldID, "pvmMatrix", [gl.PERSPECTIVE, gl.VIEW, gl.MODEL], cameraID,
+			position=glm.vec3(i, 0.0, 0.0), scale=glm.vec3(1.0)
+		);
+		gl.record_run(listID, worldID);
+
+	python:list[float] = timeFrames("Python loop", pythonFrame);
+	native:list[float] = timeFrames("gl.submit()", lambda: gl.submit(listID));
+	print(f"{Colours.SUCCESS}[PY ] Command list speedup: {statistics.fmean(python) / statistics.fmean(native):.2f}x{Colours.MINOR}");
+	gl.delete_command_list(listID);
+
+
+def benchDrawQueue(cameraID:int) -> None:
+	#Draws interleaving 4 shaders & 8 meshes: gl.run() each in that order vs one sorted gl.flush_draw_queue().
+	print(f"{Colours.MAJOR}[PY ] Draw queue: gl.run() in submission order vs sorted flush{Colours.MINOR}");
+	shaderIDs:list[int] = [gl.load_shader(gl.WORLDSPACE, "shaders/worldspace.vert", "shaders/uv.3D.frag") for _ in range(4)];
+	pvm:glm.mat4 = glm.mat4(gl.get_matrix(gl.PERSPECTIVE, cameraID)) * glm.mat4(gl.get_matrix(gl.VIEW, cameraID));
+	vertices, indices = makeGrid(4, "rows");
+	meshIDs:list[int] = [gl.create_mesh(gl.POS_UV2D, vertices, indices) for _ in range(8)];
+	draws:list[tuple[int, int]] = [(shaderIDs[i % len(shaderIDs)], meshIDs[i % len(meshIDs)]) for i in range(256)];
+	gl.configure(gl.WORLDSPACE);
+	queueID:int = gl.create_draw_queue("bench");
+
+	def submissionOrder() -> None:
+		for shaderID, meshID in draws:
+			gl.add_uniform_value(shaderID, "pvmMatrix", pvm);
+			gl.run(shaderID, mesh=meshID);
+		gl.update_window();
+
+	def queuedOrder() -> None:
+		for i, (shaderID, meshID) in enumerate(draws):
+			gl.queue_draw(queueID, shaderID, mesh=meshID, uniforms={"pvmMatrix": pvm}, depth=float(i));
+		gl.flush_draw_queue(queueID);
+		gl.update_window();
+
+	python:list[float] = timeFrames(f"gl.run() x{len(draws)}", submissionOrder);
+	queued:list[float] = timeFrames(f"gl.queue_draw() x{len(draws)} + flush", queuedOrder);
+	for shaderID, meshID in draws: gl.queue_draw(queueID, shaderID, mesh=meshID);
+	stats:dict = gl.flush_draw_queue(queueID);
+	print(f"{Colours.VALUE}[PY ] State switches: {stats['unsorted']} in submission order, {stats['switches']} sorted ({stats['avoided']} avoided){Colours.MINOR}");
+	print(f"{Colours.SUCCESS}[PY ] Draw queue speedup: {statistics.fmean(python) / statistics.fmean(queued):.2f}x{Colours.MINOR}");
+	gl.delete_draw_queue(queueID);
+	for meshID in meshIDs: gl.delete_mesh(meshID);
+
+
+######## BENCHMARKS ########
+
+
+
+
+
+
+
+
+def main() -> None:
+	print(f"{Colours.WARNING}[PY ] Running benchmark python script;{Colours.MINOR}");
+	gl.set_output(gl.SILENT); #Logging would dominate the timings.
+	gl.init(name="Bench", resolution=(800, 600), version=(4, 6), headless=True, mode=gl.CONTEXT_RELEASE);
+	cameraID:int = gl.create_camera(fov_deg=70.0, near_z=0.1, far_z=100.0);
+
+	benchCommandList(cameraID);
+	benchModelMatrices();
+	benchMeshOptimize(cameraID);
+	benchVertexPacking(cameraID);
+	benchMeshDraws(cameraID);
+	benchDrawQueue(cameraID);
+
+	gl.terminate();
+	print(f"{Colours.WARNING}[PY ] Benchmarks finished {Colours.DEFAULT}");
+
+
+
+if (__name__ == "__main__"):
+	main();
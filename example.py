@@ -26,12 +26,15 @@ def main():
 	fWorld = gl.create_texture(resVec, fill_colour=default_fill_colour) #Also sets their initial values to be the defaults.
 
 
+	world = gl.create_texture_pair(cWorld, fWorld) #Pair them, so the current/future grids can swap each step.
+
+
 	#Tell the shaders to use the textures;
 	gl.add_texture(cellShader, terrain, 0)
-	gl.add_texture(cellShader, cWorld, 1)
-	gl.add_texture(cellShader, fWorld, 2)
+	gl.add_texture_pair(cellShader, world, 1, gl.FRONT) #Read the current grid
+	gl.add_texture_pair(cellShader, world, 2, gl.BACK)  #Write the future grid
 
-	gl.add_texture(displayShader, cWorld, 0) #Show the current grid onscreen.
+	gl.add_texture_pair(displayShader, world, 0, gl.FRONT) #Show the current grid onscreen.
 
 
 	#Tell the shader what the grid size is
@@ -42,6 +45,7 @@ def main():
 
 		gl.configure(gl.ST_COMPUTE) #Set settings to compute shader style.
 		gl.run(cellShader) #Do the physics stuff
+		gl.swap(world) #Future grid becomes the current one. No copying, no re-adding textures.
 
 		gl.configure(gl.ST_SCREENSPACE) #Set settings to fullscreen shader style.
 		gl.run(displayShader) #Show onscreen
@@ -54,6 +58,7 @@ def main():
 
 	#[OPTIONAL] delete textures because they arent used
 	#If not done, then gl.terminate() does it, but its probably clearer TO do it than not.
+	gl.delete_texture_pair(world)
 	gl.delete_texture(terrain)
 	gl.delete_texture(cWorld)
 	gl.delete_texture(fWorld)
@@ -7,6 +7,10 @@
 #include "src/global.h"
 #include "src/utils.h"
 #include "src/graphics.h"
+#include "src/profiler.h"
+#include "src/pacing.h"
+#include "src/input.h"
+#include "src/debug.h"
 
 
 //////// PY MODULE ////////
@@ -27,45 +31,135 @@ const std::unordered_map<Verbosity, std::string> vLevelMap = {
 };
 void setVerbosity(Verbosity level) {
 	shared::verbose = level;
-	utils::cout(V_SILENT, std::format("Set console output level to: {}", vLevelMap.at(level)));
+	GL_LOG(V_SILENT, std::format("Set console output level to: {}", vLevelMap.at(level)));
+}
+
+void setLogSink(LogSink sink, const std::string& filePath) {
+	if ((sink == LS_FILE) && filePath.empty()) {utils::cerr("A log file path is needed for gl.LOG_FILE.");}
+	logger::setSink(sink, filePath);
 }
 
 
 void updateWindow() {
-	if (shared::window) {
-		glfwSwapBuffers(shared::window);
+	PROFILE_ZONE("update_window");
+	graphics::checkContextThread("update_window");
+	{PROFILE_ZONE("frame_limit"); pacing::wait();}
+
+	if (shared::headless) {
+		//Nothing to present. Just start the next frame clean.
+		glstate::bindFramebuffer(shared::defaultFramebuffer);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+	else if (shared::window) {
+		{PROFILE_ZONE("swap_buffers"); glfwSwapBuffers(shared::window);}
+		glstate::bindFramebuffer(shared::defaultFramebuffer);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	}
 	else {utils::cerr("You need to initialise GL first → gl.init()");}
+	pacing::endFrame();
+	glstate::endFrame();
+	shared::frameIndex++;
+}
+
+void setSwapInterval(int interval) {
+	graphics::checkContextThread("set_swap_interval");
+	if (!shared::window) {
+		GL_LOG_MINIMAL("No window to swap, ignoring swap interval.");
+		return;
+	}
+
+	//Adaptive vsync (tear when late instead of waiting a whole extra refresh) needs an extension.
+	if ((interval < 0) && !glfwExtensionSupported("WGL_EXT_swap_control_tear") && !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+		GL_LOG_MINIMAL(std::format("Adaptive vsync is not supported, using swap interval [{}] instead.", -interval));
+		interval = -interval;
+	}
+
+	GL_LOG_MINIMAL(std::format("Set swap interval to [{}]", interval));
+	glfwSwapInterval(interval);
+	pacing::swapInterval = interval;
+	pacing::clear();
+}
+
+void setFrameLimit(float fps) {
+	graphics::checkContextThread("set_frame_limit"); //gl.update_window() reads the limit with the GIL released.
+	if (fps < 0.0f) {utils::cerr(std::format("Frame limit must be positive, or 0 to disable, got [{}]", fps));}
+
+	GL_LOG_MINIMAL((fps > 0.0f) ? std::format("Limiting frame rate to [{}] FPS", fps) : std::string("Disabled frame limiter"));
+	pacing::limit = (fps > 0.0f)
+		? std::chrono::duration_cast<pacing::Clock::duration>(std::chrono::duration<double>(1.0 / fps))
+		: pacing::Clock::duration::zero();
+	pacing::deadline = {};
+	pacing::clear();
 }
 
 void pollEvents() {
+	PROFILE_ZONE("poll_events");
+	graphics::checkContextThread("poll_events");
+	if (shared::headless) {return; /* No window, no events. */}
 	if (shared::window) {
 		//Keyboard/Mouse events
+		input::beginPoll();
 		glfwPollEvents();
-		previousKeyMap = currentKeyMap;
 
 		//Cursor movement.
 		previousCursorPosition = currentCursorPosition;
 		glfwGetCursorPos(shared::window, &currentCursorPosition.x, &currentCursorPosition.y);
+
+		input::refreshSnapshot(currentCursorPosition, currentCursorPosition - previousCursorPosition);
 	}
 	else {utils::cerr("You need to initialise GL first → gl.init()");}
 }
 
 
 bool keyHeld(int key) {
-	return currentKeyMap[key];
+	return input::validKey(key) && input::held.test(key);
 }
 
 bool keyPressed(int key) {
-	return currentKeyMap[key] && !previousKeyMap[key];
+	return input::validKey(key) && input::pressed.test(key);
 }
 
 bool keyReleased(int key) {
-	return !currentKeyMap[key] && previousKeyMap[key];
+	return input::validKey(key) && input::released.test(key);
+}
+
+template<typename T, size_t N>
+py::array snapshotView(std::array<T, N>& data) {
+	//Read-only view onto the snapshot. It lives as long as the module, so the base owns nothing.
+	py::array view = py::array_t<T>({N}, {sizeof(T)}, data.data(), py::capsule(data.data(), [](void*) {}));
+	view.attr("setflags")(py::arg("write")=false);
+	return view;
+}
+
+py::dict inputSnapshot() {
+	graphics::checkContextThread("input_snapshot"); //The views are refreshed in place by gl.poll_events(), without a lock.
+	py::dict out;
+	out["held"] = snapshotView(input::snapshot.held);
+	out["pressed"] = snapshotView(input::snapshot.pressed);
+	out["released"] = snapshotView(input::snapshot.released);
+	out["mouse_held"] = snapshotView(input::snapshot.buttonsHeld);
+	out["mouse_pressed"] = snapshotView(input::snapshot.buttonsPressed);
+	out["mouse_released"] = snapshotView(input::snapshot.buttonsReleased);
+	out["cursor"] = snapshotView(input::snapshot.cursor);
+	out["cursor_delta"] = snapshotView(input::snapshot.cursorDelta);
+	out["scroll"] = snapshotView(input::snapshot.scroll);
+	return out;
+}
+
+py::list drainEvents() {
+	//[(type, time, code, action, mods, x, y), ...] oldest first.
+	py::list out;
+	input::events.drain([&out](const input::Event& e) {
+		out.append(py::make_tuple(e.type, e.time, e.code, e.action, e.mods, e.x, e.y));
+	});
+	if (uint64_t dropped = input::events.takeDropped()) {
+		GL_LOG_MINIMAL(std::format("Input event queue was full, dropped [{}] events. Drain it more often.", dropped));
+	}
+	return out;
 }
 
 bool windowOpen() {
+	if (shared::headless) {return shared::init; /* Open until gl.terminate() */}
 	if (!shared::window) {return false; /* No window open so "close" it */}
 	return !glfwWindowShouldClose(shared::window);
 }
@@ -86,33 +180,369 @@ glm::vec2 getCursorDelta() {
 
 void setCursorPos(glm::vec2 position) {
 	//Defaults to 0, 0 if no arg passed.
+	if (!shared::window) {return; /* Headless, no cursor. */}
 	glfwSetCursorPos(shared::window, position.x, position.y);
 }
 
-void cursorShow() {glfwSetInputMode(shared::window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);}
-void cursorHide() {glfwSetInputMode(shared::window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);}
+void cursorShow() {if (shared::window) {glfwSetInputMode(shared::window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);}}
+void cursorHide() {if (shared::window) {glfwSetInputMode(shared::window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);}}
 
 
 
-void manageAddVAO(int shader, VAOFormat format, py::array_t<float> vertArr, py::array_t<int> indArray) {
+void manageAddVAO(int shader, VAOFormat format, py::array_t<float, py::array::c_style | py::array::forcecast> vertArr, py::array_t<uint32_t, py::array::c_style | py::array::forcecast> indArray, bool optimize, VertexPacking packing) {
 	//Translate python array type (list, tuple, numpy.ndarray) into vector and pass to graphics::addVao() func.
-	py::buffer_info vInfo = vertArr.request();
-	float* vData = static_cast<float*>(vInfo.ptr);
-	size_t vSize = vInfo.size;
-	std::vector<float> vertices = std::vector<float>(vData, vData + vSize);
+	std::vector<float> vertices = std::vector<float>(vertArr.data(), vertArr.data() + vertArr.size());
+	std::vector<GLuint> indices = std::vector<GLuint>(indArray.data(), indArray.data() + indArray.size());
+
+	graphics::shader::addVAO(shader, format, vertices, indices, optimize, packing);
+}
+
+
+//GL type of a vertex attribute stored as this numpy dtype.
+GLenum vertexTypeOf(const py::dtype& dtype) {
+	if (py::str(dtype.attr("byteorder")).cast<std::string>() == ">") {utils::cerr("Vertex attributes must be little-endian");}
+	switch (dtype.kind()) {
+		case 'f': {if (dtype.itemsize() == 2) {return GL_HALF_FLOAT;} if (dtype.itemsize() == 4) {return GL_FLOAT;} break;}
+		case 'i': {if (dtype.itemsize() == 1) {return GL_BYTE;} if (dtype.itemsize() == 2) {return GL_SHORT;} if (dtype.itemsize() == 4) {return GL_INT;} break;}
+		case 'u': {if (dtype.itemsize() == 1) {return GL_UNSIGNED_BYTE;} if (dtype.itemsize() == 2) {return GL_UNSIGNED_SHORT;} if (dtype.itemsize() == 4) {return GL_UNSIGNED_INT;} break;}
+		default: {break;}
+	}
+	utils::cerr(std::format("Vertex attributes can't be [{}], use float16/32 or (u)int8/16/32", py::str(dtype).cast<std::string>()));
+	return GL_FLOAT;
+}
+
+
+//(location, components, type, normalised, offset[, stream]). Integers that aren't normalised are read as ints.
+vertexpack::AttributeFormat attributeFromTuple(py::handle item) {
+	py::sequence entry = item.cast<py::sequence>();
+	if ((entry.size() != 5u) && (entry.size() != 6u)) {
+		utils::cerr("Layout attributes are (location, components, type, normalised, offset) with an optional stream index");
+	}
+	vertexpack::AttributeFormat attr;
+	attr.location = entry[0].cast<GLuint>();
+	attr.size = attr.components = entry[1].cast<GLint>();
+	std::string typeName = py::isinstance<py::str>(entry[2]) ? entry[2].cast<std::string>() : "";
+	if (typeName == "int_2_10_10_10_rev") {attr.type = GL_INT_2_10_10_10_REV;}
+	else if (typeName == "uint_2_10_10_10_rev") {attr.type = GL_UNSIGNED_INT_2_10_10_10_REV;}
+	else {attr.type = vertexTypeOf(py::dtype::from_args(entry[2]));}
+	attr.normalized = entry[3].cast<bool>() ? GL_TRUE : GL_FALSE;
+	attr.offset = entry[4].cast<GLuint>();
+	attr.stream = (entry.size() == 6u) ? entry[5].cast<GLuint>() : 0u;
+	bool floatType = (attr.type == GL_FLOAT) || (attr.type == GL_HALF_FLOAT) || (attr.type == GL_INT_2_10_10_10_REV) || (attr.type == GL_UNSIGNED_INT_2_10_10_10_REV);
+	attr.integer = !floatType && !attr.normalized;
+	return attr;
+}
+
+
+//One attribute per field of a structured dtype, at the next free locations.
+//8/16-bit integer fields are normalised (colours, weights), 32-bit ones are read as ints (IDs, bone indices).
+void attributesFromDtype(const py::dtype& dtype, GLuint stream, std::vector<vertexpack::AttributeFormat>& out) {
+	if (dtype.attr("names").is_none()) {utils::cerr("A layout dtype must be structured, with a field per attribute");}
+	py::dict fields = dtype.attr("fields");
+	for (py::handle name : dtype.attr("names")) {
+		py::tuple field = fields[name]; //(dtype, offset[, title])
+		py::dtype fieldType = field[0].cast<py::dtype>();
+		GLint components = 1;
+		if (!fieldType.attr("subdtype").is_none()) { //e.g. ("position", "<f4", (3,))
+			py::tuple subarray = fieldType.attr("subdtype");
+			fieldType = subarray[0].cast<py::dtype>();
+			for (py::handle extent : subarray[1]) {components *= extent.cast<GLint>();}
+		}
+
+		vertexpack::AttributeFormat attr;
+		attr.location = static_cast<GLuint>(out.size());
+		attr.size = attr.components = components;
+		attr.type = vertexTypeOf(fieldType);
+		attr.offset = field[1].cast<GLuint>();
+		attr.stream = stream;
+		bool integerType = (attr.type != GL_FLOAT) && (attr.type != GL_HALF_FLOAT);
+		attr.normalized = (integerType && (fieldType.itemsize() < 4)) ? GL_TRUE : GL_FALSE;
+		attr.integer = integerType && !attr.normalized;
+		out.push_back(attr);
+	}
+}
+
+
+//A custom layout's attributes, and streams pointing into arrays (kept here, so they outlive the streams).
+struct PyLayout {
+	std::vector<py::array> arrays;
+	std::vector<vertexpack::AttributeFormat> attributes;
+	std::vector<vertexpack::VertexStream> streams;
+};
+
+PyLayout parseLayout(py::object layout, py::object vertices) {
+	PyLayout out;
+	//One buffer, or a list of them (one per stream). Read as raw bytes, so they're never converted.
+	auto addStream = [&out](py::handle stream) {
+		if (!py::isinstance<py::buffer>(stream)) {utils::cerr("Vertex streams must be numpy arrays (or other buffers) for a custom layout");}
+		py::array arr = py::array::ensure(stream, py::array::c_style);
+		if (!arr || (arr.ndim() == 0)) {utils::cerr("Vertex streams need at least one dimension");}
+		out.arrays.push_back(arr);
+	};
+	if (py::isinstance<py::buffer>(vertices)) {addStream(vertices);}
+	else {for (py::handle stream : vertices) {addStream(stream);}}
+
+	if (py::isinstance<py::dtype>(layout)) {attributesFromDtype(layout.cast<py::dtype>(), 0u, out.attributes);}
+	else {
+		GLuint dtypeStream = 0u;
+		for (py::handle item : layout) {
+			if (py::isinstance<py::dtype>(item)) {attributesFromDtype(item.cast<py::dtype>(), dtypeStream++, out.attributes);}
+			else {out.attributes.push_back(attributeFromTuple(item));}
+		}
+	}
+
+	//Rows of (N, ...) or structured arrays are one vertex, a flat array is taken as tightly packed attributes.
+	for (size_t s=0; s<out.arrays.size(); s++) {
+		const py::array& arr = out.arrays[s];
+		GLuint stride = 0u;
+		if ((arr.ndim() >= 2) || !arr.dtype().attr("names").is_none()) {stride = static_cast<GLuint>(arr.strides(0));}
+		else {
+			for (const vertexpack::AttributeFormat& attr : out.attributes) {
+				if (attr.stream == s) {stride = std::max(stride, attr.offset + vertexpack::bytesOf(attr));}
+			}
+		}
+		out.streams.push_back({arr.data(), static_cast<size_t>(arr.nbytes()), stride});
+	}
+	return out;
+}
+
+
+void manageAddVAOLayout(int shader, py::object layout, py::object vertices, py::array_t<uint32_t, py::array::c_style | py::array::forcecast> indArray) {
+	PyLayout parsed = parseLayout(layout, vertices);
+	std::vector<GLuint> indices = std::vector<GLuint>(indArray.data(), indArray.data() + indArray.size());
+	graphics::shader::addVAOLayout(shader, parsed.attributes, parsed.streams, indices);
+}
+
+
+int manageCreateMesh(VAOFormat format, py::array_t<float, py::array::c_style | py::array::forcecast> vertArr, py::array_t<uint32_t, py::array::c_style | py::array::forcecast> indArray, bool optimize, VertexPacking packing, std::string name) {
+	std::vector<float> vertices = std::vector<float>(vertArr.data(), vertArr.data() + vertArr.size());
+	std::vector<GLuint> indices = std::vector<GLuint>(indArray.data(), indArray.data() + indArray.size());
+	return graphics::geometry::create(format, vertices, indices, optimize, packing, name);
+}
+
+
+int manageCreateMeshLayout(py::object layout, py::object vertices, py::array_t<uint32_t, py::array::c_style | py::array::forcecast> indArray, std::string name) {
+	PyLayout parsed = parseLayout(layout, vertices);
+	std::vector<GLuint> indices = std::vector<GLuint>(indArray.data(), indArray.data() + indArray.size());
+	return graphics::geometry::createLayout(parsed.attributes, parsed.streams, indices, name);
+}
+
+
+py::dict manageLoadMesh(int shader, std::string filePath, bool optimize, VertexPacking packing) {
+	mesh::Info info;
+	{
+		py::gil_scoped_release release; //Parsing a big file shouldn't hold up other Python threads.
+		info = graphics::shader::loadMesh(shader, filePath, optimize, packing);
+	}
+
+	py::dict out;
+	out["format"] = info.format;
+	out["vertices"] = info.vertices;
+	out["indices"] = info.indices;
+	out["bounds_min"] = info.boundsMin;
+	out["bounds_max"] = info.boundsMax;
+	out["acmr_before"] = info.acmrBefore;
+	out["acmr_after"] = info.acmrAfter;
+	return out;
+}
+
+
+py::dict manageOptimizeMesh(VAOFormat format, py::array_t<float, py::array::c_style | py::array::forcecast> vertArr, py::array_t<uint32_t, py::array::c_style | py::array::forcecast> indArray) {
+	//Same passes as add_vao(optimize=True), handing the result back rather than uploading it.
+	if (format == VAO_EMPTY) {utils::cerr("optimize_mesh needs a vertex format with positions");}
+	size_t stride = constants::display::vertexFormatSizeMap.at(format);
+	if ((vertArr.size() % static_cast<py::ssize_t>(stride)) != 0) {
+		utils::cerr(std::format("vertices has [{}] values, not a multiple of the format's [{}] per vertex", vertArr.size(), stride));
+	}
+	std::vector<float> vertices(vertArr.data(), vertArr.data() + vertArr.size());
+	std::vector<GLuint> indices(indArray.data(), indArray.data() + indArray.size());
+
+	meshopt::Stats stats;
+	{
+		py::gil_scoped_release release;
+		stats = meshopt::optimize(vertices, stride, indices);
+	}
+
+	py::array_t<float> outVertices({vertices.size() / stride, stride});
+	std::copy(vertices.begin(), vertices.end(), outVertices.mutable_data());
+	py::array_t<uint32_t> outIndices(indices.size());
+	std::copy(indices.begin(), indices.end(), outIndices.mutable_data());
+
+	py::dict out;
+	out["vertices"] = outVertices;
+	out["indices"] = outIndices;
+	out["acmr_before"] = stats.acmrBefore;
+	out["acmr_after"] = stats.acmrAfter;
+	return out;
+}
+
+
+using FloatArray = py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+FloatArray manageModelMatrices(FloatArray positions, FloatArray rotations, FloatArray scales) {
+	//(N,3) ×3 → (N,4,4), each matrix laid out like glm (column-major), so glm.mat4(out[i]) works.
+	auto checkShape = [](const FloatArray& arr, const char* name) {
+		if ((arr.ndim() != 2) || (arr.shape(1) != 3)) {
+			utils::cerr(std::format("{} must be an (N, 3) array, got {} dimensions", name, arr.ndim()));
+		}
+	};
+	checkShape(positions, "positions");
+	checkShape(rotations, "rotations");
+	checkShape(scales, "scales");
+
+	size_t count = static_cast<size_t>(positions.shape(0));
+	if ((static_cast<size_t>(rotations.shape(0)) != count) || (static_cast<size_t>(scales.shape(0)) != count)) {
+		utils::cerr(std::format(
+			"positions, rotations and scales must have the same length, got [{}, {}, {}]",
+			count, rotations.shape(0), scales.shape(0)
+		));
+	}
 
-	py::buffer_info iInfo = indArray.request();
-	int* iData = static_cast<int*>(iInfo.ptr);
-	size_t iSize = iInfo.size;
-	std::vector<int> indices = std::vector<int>(iData, iData + iSize);
+	FloatArray out({count, size_t(4), size_t(4)});
+	const float* p = positions.data();
+	const float* r = rotations.data();
+	const float* s = scales.data();
+	float* o = out.mutable_data();
+	{
+		py::gil_scoped_release release; //Only touches the arrays' memory, which the caller keeps alive.
+		graphics::matrices::getModelMatrices(p, r, s, o, count);
+	}
+	return out;
+}
 
-	graphics::shader::addVAO(shader, format, vertices, indices);
+
+py::dict manageCameraMatrices(int cameraID) {
+	const types::Camera::Matrices& matrices = graphics::camera::getMatrices(cameraID);
+	const types::Camera& camera = shared::cameras[cameraID];
+
+	py::dict out;
+	out["view"] = matrices.view;
+	out["projection"] = matrices.projection;
+	out["view_projection"] = matrices.viewProjection;
+	out["inverse_view"] = matrices.inverseView;
+	out["inverse_projection"] = matrices.inverseProjection;
+	out["inverse_view_projection"] = matrices.inverseViewProjection;
+	out["position"] = camera.position;
+	out["forward"] = camera.forward;
+	out["right"] = camera.right;
+	out["up"] = camera.up;
+	return out;
 }
 
 
-void manageInit(std::string name, glm::ivec2 resolution, glm::uvec2 versionUV3, bool core) {
+py::array manageCull(int cameraID, FloatArray bounds, bool mask) {
+	//(N,4) spheres or (N,6) AABBs → (N,) bool mask, or the visible indices as uint32.
+	if ((bounds.ndim() != 2) || ((bounds.shape(1) != 4) && (bounds.shape(1) != 6))) {
+		utils::cerr("bounds must be an (N, 4) array of spheres [x, y, z, radius] or (N, 6) of AABBs [min xyz, max xyz]");
+	}
+	size_t count = static_cast<size_t>(bounds.shape(0));
+	size_t stride = static_cast<size_t>(bounds.shape(1));
+
+	if (mask) {
+		py::array_t<bool> out(count);
+		graphics::camera::cull(cameraID, bounds.data(), count, stride, reinterpret_cast<uint8_t*>(out.mutable_data()));
+		return out;
+	}
+
+	thread_local std::vector<uint8_t> visible;
+	visible.resize(count);
+	graphics::camera::cull(cameraID, bounds.data(), count, stride, visible.data());
+
+	size_t total = 0u;
+	for (uint8_t v : visible) {total += v;}
+	py::array_t<uint32_t> out(total);
+	uint32_t* indices = out.mutable_data();
+	for (size_t i=0; i<count; i++) {
+		if (visible[i]) {*(indices++) = static_cast<uint32_t>(i);}
+	}
+	return out;
+}
+
+
+py::dict manageFrameStats(bool reset) {
+	//{"frames", "mean_ms", "p50_ms", "p99_ms", "target_ms", "missed"}
+	pacing::FrameStats stats = pacing::stats();
+	if (reset) {pacing::clearFrames();}
+
+	py::dict out;
+	out["frames"] = stats.frames;
+	out["mean_ms"] = stats.mean;
+	out["p50_ms"] = stats.p50;
+	out["p99_ms"] = stats.p99;
+	out["target_ms"] = stats.target;
+	out["missed"] = stats.missed;
+	return out;
+}
+
+
+py::dict manageStateStats() {
+	//{"issued", "skipped"} state changes, over the last complete frame.
+	graphics::checkContextThread("get_state_stats"); //gl.update_window() ends the frame with the GIL released.
+	py::dict out;
+	out["issued"] = glstate::lastFrame.issued;
+	out["skipped"] = glstate::lastFrame.skipped;
+	return out;
+}
+
+
+py::dict manageFlushDrawQueue(int queueID) {
+	//{"draws", "switches", "unsorted", "avoided", "targets", "programs", "textures", "meshes"}
+	drawqueue::Stats stats = graphics::drawQueue::flush(queueID);
+	py::dict out;
+	out["draws"] = stats.draws;
+	out["switches"] = stats.made.total();
+	out["unsorted"] = stats.unsorted.total();
+	out["avoided"] = stats.avoided();
+	out["targets"] = stats.made.targets;
+	out["programs"] = stats.made.programs;
+	out["textures"] = stats.made.textures;
+	out["meshes"] = stats.made.meshes;
+	return out;
+}
+
+
+py::dict manageGetGPUTimings() {
+	//{shader ID : {"name", "samples", "mean_us", "min_us", "max_us", "p95_us"}}
+	py::dict out;
+	for (const auto& [ID, stats] : graphics::shader::getGPUTimings()) {
+		py::dict entry;
+		entry["name"] = shared::shaders[ID].name;
+		entry["samples"] = stats.samples;
+		entry["mean_us"] = stats.mean;
+		entry["min_us"] = stats.min;
+		entry["max_us"] = stats.max;
+		entry["p95_us"] = stats.p95;
+		out[py::int_(ID)] = entry;
+	}
+	return out;
+}
+
+
+void manageInit(std::string name, glm::ivec2 resolution, glm::uvec2 versionUV3, bool core, bool headless, ContextMode mode) {
 	types::GLVersion version = types::GLVersion(versionUV3, !core); //Takes "Is embedded" but we have "Is core". They are opposites.
-	graphics::init(name, resolution, version);
+	graphics::init(name, resolution, version, headless, mode);
+}
+
+
+py::list getDebugMessages(bool clear) {
+	uint64_t dropped = 0u;
+	std::vector<gldebug::Message> messages = gldebug::take(clear, dropped);
+	if (dropped > 0u) {
+		GL_LOG_MINIMAL(std::format("[{}] distinct debug messages were not kept, the limit is [{}].", dropped, constants::misc::MAX_DEBUG_MESSAGES));
+	}
+
+	py::list out;
+	for (const gldebug::Message& msg : messages) {
+		py::dict entry;
+		entry["id"] = msg.id;
+		entry["source"] = gldebug::sourceName(msg.source);
+		entry["type"] = gldebug::typeName(msg.type);
+		entry["severity"] = gldebug::severityName(msg.severity);
+		entry["message"] = msg.text;
+		entry["count"] = msg.count;
+		out.append(entry);
+	}
+	return out;
 }
 
 
@@ -168,6 +598,14 @@ PYBIND11_MODULE(gl, m) {
 		.export_values();
 
 
+	//How vertices are stored on the GPU
+	py::enum_<VertexPacking>(m, documentation::GLenum::VertexPacking) //Vertex packing Enum
+		.value("PACK_FLOAT", 	VertexPacking::VP_FLOAT)
+		.value("PACK_HALF", 	VertexPacking::VP_HALF)
+		.value("PACK_COMPACT", 	VertexPacking::VP_COMPACT)
+		.export_values();
+
+
 	//Types of matrix that can be created
 	py::enum_<MatrixType>(m, documentation::GLenum::MatrixType) //Matrix Type Enum
 		.value("IDENTITY", 		MatrixType::MAT_IDENTITY)
@@ -186,10 +624,56 @@ PYBIND11_MODULE(gl, m) {
 		.export_values();
 
 
+	//Sides of a texture pair
+	py::enum_<PairSide>(m, documentation::GLenum::PairSide) //Pair side Enum
+		.value("FRONT", 	PairSide::PS_FRONT)
+		.value("BACK", 		PairSide::PS_BACK)
+		.export_values();
+
+
+	//Image access for texture bindings
+	py::enum_<ImageAccess>(m, documentation::GLenum::ImageAccess) //Image access Enum
+		.value("AUTO", 			ImageAccess::IA_AUTO)
+		.value("READ", 			ImageAccess::IA_READ)
+		.value("WRITE", 		ImageAccess::IA_WRITE)
+		.value("READ_WRITE", 	ImageAccess::IA_READ_WRITE)
+		.export_values();
+
+
+	//How memory barriers are issued
+	py::enum_<BarrierMode>(m, documentation::GLenum::BarrierMode) //Barrier mode Enum
+		.value("BARRIER_TRACKED", 	BarrierMode::BM_TRACKED)
+		.value("BARRIER_ALWAYS", 	BarrierMode::BM_ALWAYS)
+		.value("BARRIER_VERIFY", 	BarrierMode::BM_VERIFY)
+		.export_values();
+
+	py::enum_<ContextMode>(m, documentation::GLenum::ContextMode) //Context mode Enum
+		.value("CONTEXT_DEBUG",   ContextMode::CM_DEBUG)
+		.value("CONTEXT_RELEASE", ContextMode::CM_RELEASE)
+		.export_values();
+
+	py::enum_<LogSink>(m, documentation::GLenum::LogSink) //Log sink Enum
+		.value("LOG_STDOUT", LogSink::LS_STDOUT)
+		.value("LOG_FILE",   LogSink::LS_FILE)
+		.value("LOG_PYTHON", LogSink::LS_PYTHON)
+		.export_values();
+
+	py::enum_<InputEventType>(m, documentation::GLenum::InputEventType) //Input event Enum
+		.value("EVENT_KEY", 			InputEventType::IE_KEY)
+		.value("EVENT_MOUSE_BUTTON", 	InputEventType::IE_MOUSE_BUTTON)
+		.value("EVENT_SCROLL", 			InputEventType::IE_SCROLL)
+		.export_values();
+
+
 	//Maximum quantities of certain types
 	m.attr("MAX_SHADERS")  = constants::misc::MAX_SHADERS;
 	m.attr("MAX_TEXTURES") = constants::misc::MAX_TEXTURES;
 	m.attr("MAX_CAMERAS")  = constants::misc::MAX_CAMERAS;
+	m.attr("MAX_TEXTURE_PAIRS") = constants::misc::MAX_TEXTURE_PAIRS;
+	m.attr("MAX_FRAMEBUFFERS") = constants::misc::MAX_FRAMEBUFFERS;
+	m.attr("MAX_COMMAND_LISTS") = constants::misc::MAX_COMMAND_LISTS;
+	m.attr("MAX_MESHES") = constants::misc::MAX_MESHES;
+	m.attr("MAX_DRAW_QUEUES") = constants::misc::MAX_DRAW_QUEUES;
 
 
 
@@ -205,12 +689,28 @@ PYBIND11_MODULE(gl, m) {
 		py::arg("level")=V_SILENT, documentation::meta::verbose
 	);
 
-	m.def("init", &manageInit, //gl.init(name="", resolution=(0,0), version=(3,3), core=true)
+	m.def("set_log_sink", &setLogSink, //gl.set_log_sink(sink, path="")
+		py::arg("sink")=LS_STDOUT, py::arg("path")="", documentation::meta::logSink
+	);
+
+	m.def("flush_log", &logger::flush, //gl.flush_log()
+		documentation::meta::flushLog
+	);
+
+	//The log thread must be stopped before the interpreter is.
+	py::module_::import("atexit").attr("register")(py::cpp_function(&logger::shutdown));
+
+	m.def("init", &manageInit, //gl.init(name="", resolution=(0,0), version=(3,3), core=true, headless=false, mode=gl.CONTEXT_DEBUG)
 		py::arg("name")="GLFW/py-graphics", py::arg("resolution")=glm::ivec2(0,0),
-		py::arg("version")=glm::ivec2(3, 3), py::arg("core")=true,
+		py::arg("version")=glm::ivec2(3, 3), py::arg("core")=true, py::arg("headless")=false,
+		py::arg("mode")=CM_DEBUG,
 		documentation::window::init
 	);
 
+	m.def("get_debug_messages", &getDebugMessages, //gl.get_debug_messages(clear=True)
+		py::arg("clear")=true, documentation::window::debugMessages
+	);
+
 	m.def("terminate", &graphics::terminate, //gl.terminate()
 		documentation::window::terminate
 	); 
@@ -233,8 +733,29 @@ PYBIND11_MODULE(gl, m) {
 		py::arg("key"), documentation::window::wasKeyReleased
 	);
 
-	m.def("update_window", &updateWindow,
-		documentation::window::update
+	//Blocking calls release the GIL, so other Python threads keep running while they wait.
+	m.def("input_snapshot", &inputSnapshot, //gl.input_snapshot()
+		documentation::window::inputSnapshot
+	);
+
+	m.def("drain_events", &drainEvents, //gl.drain_events()
+		documentation::window::drainEvents
+	);
+
+	m.def("update_window", &updateWindow, //gl.update_window()
+		py::call_guard<py::gil_scoped_release>(), documentation::window::update
+	);
+
+	m.def("set_swap_interval", &setSwapInterval, //gl.set_swap_interval(interval=1)
+		py::arg("interval")=1, documentation::window::swapInterval
+	);
+
+	m.def("set_frame_limit", &setFrameLimit, //gl.set_frame_limit(fps=0.0)
+		py::arg("fps")=0.0f, documentation::window::frameLimit
+	);
+
+	m.def("frame_stats", &manageFrameStats, //gl.frame_stats(reset=False)
+		py::arg("reset")=false, documentation::window::frameStats
 	);
 
 	m.def("poll_events", &pollEvents,
@@ -267,10 +788,28 @@ PYBIND11_MODULE(gl, m) {
 
 
 
+	//Profiling
+	m.def("profiler_enable", &graphics::profile::enable, //gl.profiler_enable(enabled=True);
+		py::arg("enabled")=true, documentation::profile::enable
+	);
+
+	m.def("profiler_dump", &graphics::profile::dump, //gl.profiler_dump(file_path="");
+		py::arg("file_path"), documentation::profile::dump
+	);
+
+	m.def("profiler_clear", &graphics::profile::clear, //gl.profiler_clear();
+		documentation::profile::clear
+	);
+
+
+
+
+
+
 	//Shader abstractions
 	m.def("load_shader", &graphics::shader::load, //gl.load_shader(type=ST_NONE, vertex="", fragment="", compute="");
 		py::arg("type"), py::arg("vertex")="", py::arg("fragment")="",
-		py::arg("compute")="", documentation::shader::load
+		py::arg("compute")="", py::call_guard<py::gil_scoped_release>(), documentation::shader::load
 	);
 
 
@@ -282,13 +821,62 @@ PYBIND11_MODULE(gl, m) {
 	m.def(
 		"add_vao", &manageAddVAO,
 		py::arg("shader"), py::arg("format")=VAO_EMPTY,
-		py::arg("vertices")=py::list(), py::arg("indices")=py::list(),
+		py::arg("vertices")=py::list(), py::arg("indices")=py::list(), py::arg("optimize")=false, py::arg("packing")=VP_FLOAT,
 		documentation::shader::addVAO
 	);
+	m.def(
+		"add_vao", &manageAddVAOLayout,
+		py::arg("shader"), py::arg("layout"), py::arg("vertices"), py::arg("indices")=py::list(),
+		documentation::shader::addVAOLayout
+	);
 
 
-	m.def("run", &graphics::shader::run, //gl.run(shader=-1, dispatch=(0, 0, 0));
-		py::arg("shader"), py::arg("dispatch")=glm::uvec3(0u, 0u, 0u), documentation::shader::run
+	m.def("load_mesh", &manageLoadMesh, //gl.load_mesh(shader=-1, file_path="", optimize=False, packing=gl.PACK_FLOAT);
+		py::arg("shader"), py::arg("file_path"), py::arg("optimize")=false, py::arg("packing")=VP_FLOAT,
+		documentation::shader::loadMesh
+	);
+
+
+	m.def("optimize_mesh", &manageOptimizeMesh, //gl.optimize_mesh(format=gl.POS_ONLY, vertices=[], indices=[]);
+		py::arg("format"), py::arg("vertices"), py::arg("indices"),
+		documentation::shader::optimizeMesh
+	);
+
+
+	m.def("run", &graphics::shader::run, //gl.run(shader=-1, dispatch=(0, 0, 0), target=-1, mesh=-1);
+		py::arg("shader"), py::arg("dispatch")=glm::uvec3(0u, 0u, 0u), py::arg("target")=-1, py::arg("mesh")=-1,
+		documentation::shader::run
+	);
+
+
+	m.def("draw", &graphics::shader::draw, //gl.draw(shader=-1, meshes=[], target=-1);
+		py::arg("shader"), py::arg("meshes"), py::arg("target")=-1,
+		documentation::shader::draw
+	);
+
+
+	m.def("enable_gpu_timing", &graphics::shader::enableGPUTiming, //gl.enable_gpu_timing(enabled=True);
+		py::arg("enabled")=true, documentation::shader::enableGPUTiming
+	);
+
+
+	m.def("get_gpu_timings", &manageGetGPUTimings, //gl.get_gpu_timings();
+		documentation::shader::getGPUTimings
+	);
+
+
+	m.def("get_state_stats", &manageStateStats, //gl.get_state_stats();
+		documentation::shader::stateStats
+	);
+
+
+	m.def("set_barrier_mode", &graphics::shader::setBarrierMode, //gl.set_barrier_mode(mode=gl.BARRIER_TRACKED);
+		py::arg("mode")=BM_TRACKED, documentation::shader::barrierMode
+	);
+
+
+	m.def("get_barrier_count", &graphics::shader::barrierCount, //gl.get_barrier_count();
+		documentation::shader::barrierCount
 	);
 
 
@@ -299,15 +887,96 @@ PYBIND11_MODULE(gl, m) {
 
 
 
+	//Command lists
+	m.def("create_command_list", &graphics::commandList::create, //gl.create_command_list(name="");
+		py::arg("name")="", documentation::commandList::create
+	);
+
+	m.def("record_configure", &graphics::commandList::recordConfigure, //gl.record_configure(list=-1, type=ST_NONE, cull=False);
+		py::arg("list"), py::arg("type"), py::arg("cull")=false,
+		documentation::commandList::recordConfigure
+	);
+
+	m.def("record_run", &graphics::commandList::recordRun, //gl.record_run(list=-1, shader=-1, dispatch=(0, 0, 0), target=-1);
+		py::arg("list"), py::arg("shader"), py::arg("dispatch")=glm::uvec3(0u, 0u, 0u), py::arg("target")=-1,
+		documentation::commandList::recordRun
+	);
+
+	m.def("record_uniform", &graphics::commandList::recordUniform, //gl.record_uniform(list=-1, shader=-1, name="", value=0.0);
+		py::arg("list"), py::arg("shader"), py::arg("name"), py::arg("value"),
+		documentation::commandList::recordUniform
+	);
+
+	m.def("record_matrix_uniform", &graphics::commandList::recordMatrixUniform, //gl.record_matrix_uniform(list=-1, shader=-1, name="", matrices=[], camera=-1, position=(0, 0, 0), rotation=(0, 0, 0), scale=(0, 0, 0));
+		py::arg("list"), py::arg("shader"), py::arg("name"), py::arg("matrices"), py::arg("camera")=-1,
+		py::arg("position")=glm::vec3(0.0f, 0.0f, 0.0f),
+		py::arg("rotation")=glm::vec3(0.0f, 0.0f, 0.0f),
+		py::arg("scale")=glm::vec3(0.0f, 0.0f, 0.0f),
+		documentation::commandList::recordMatrixUniform
+	);
+
+	m.def("record_texture", &graphics::commandList::recordBind, //gl.record_texture(list=-1, shader=-1, texture=-1, binding=0, access=gl.AUTO);
+		py::arg("list"), py::arg("shader"), py::arg("texture"), py::arg("binding"), py::arg("access")=IA_AUTO,
+		documentation::commandList::recordBind
+	);
+
+	m.def("record_swap", &graphics::commandList::recordSwap, //gl.record_swap(list=-1, pair=-1);
+		py::arg("list"), py::arg("pair"), documentation::commandList::recordSwap
+	);
+
+	m.def("record_barrier", &graphics::commandList::recordBarrier, //gl.record_barrier(list=-1);
+		py::arg("list"), documentation::commandList::recordBarrier
+	);
+
+	m.def("submit", &graphics::commandList::submit, //gl.submit(list=-1);
+		py::arg("list"), documentation::commandList::submit
+	);
+
+	m.def("clear_command_list", &graphics::commandList::clear, //gl.clear_command_list(list=-1);
+		py::arg("list"), documentation::commandList::clear
+	);
+
+	m.def("delete_command_list", &graphics::commandList::remove, //gl.delete_command_list(list=-1);
+		py::arg("list"), documentation::commandList::remove
+	);
+
+
+
+	//Draw queues
+	m.def("create_draw_queue", &graphics::drawQueue::create, //gl.create_draw_queue(name="");
+		py::arg("name")="", documentation::drawQueue::create
+	);
+
+	m.def("queue_draw", &graphics::drawQueue::submit, //gl.queue_draw(queue=-1, shader=-1, mesh=-1, target=-1, textures={}, uniforms={}, depth=0.0, transparent=False);
+		py::arg("queue"), py::arg("shader"), py::arg("mesh")=-1, py::arg("target")=-1,
+		py::arg("textures")=std::map<GLuint, int>(), py::arg("uniforms")=py::dict(),
+		py::arg("depth")=0.0f, py::arg("transparent")=false,
+		documentation::drawQueue::submit
+	);
+
+	m.def("flush_draw_queue", &manageFlushDrawQueue, //gl.flush_draw_queue(queue=-1);
+		py::arg("queue"), documentation::drawQueue::flush
+	);
+
+	m.def("clear_draw_queue", &graphics::drawQueue::clear, //gl.clear_draw_queue(queue=-1);
+		py::arg("queue"), documentation::drawQueue::clear
+	);
+
+	m.def("delete_draw_queue", &graphics::drawQueue::remove, //gl.delete_draw_queue(queue=-1);
+		py::arg("queue"), documentation::drawQueue::remove
+	);
+
+
+
 	//Texture abstractions
 	m.def("load_texture", &graphics::texture::load, //gl.load_texture(file_path="", name="");
 		py::arg("file_path"), py::arg("name")="",
-		documentation::texture::load
+		py::call_guard<py::gil_scoped_release>(), documentation::texture::load
 	);
 
 	m.def("save_texture", &graphics::texture::save, //gl.save_texture(texture=-1, file_path="");
 		py::arg("texture"), py::arg("file_path"),
-		documentation::texture::save
+		py::call_guard<py::gil_scoped_release>(), documentation::texture::save
 	);
 
 	m.def("create_texture", &graphics::texture::create, //gl.create_texture(file_path="", fill_colour=(0.0f, 0.0f, 0.0f, 0.0f), name="");
@@ -315,8 +984,8 @@ PYBIND11_MODULE(gl, m) {
 		documentation::texture::create
 	);
 
-	m.def("add_texture", &graphics::texture::bind, //gl.add_texture(shader=-1, texture=-1, binding=0);
-		py::arg("shader"), py::arg("texture"), py::arg("binding"),
+	m.def("add_texture", &graphics::texture::bind, //gl.add_texture(shader=-1, texture=-1, binding=0, access=gl.AUTO);
+		py::arg("shader"), py::arg("texture"), py::arg("binding"), py::arg("access")=IA_AUTO,
 		documentation::texture::bind
 	);
 
@@ -324,6 +993,60 @@ PYBIND11_MODULE(gl, m) {
 		py::arg("texture"), documentation::texture::remove
 	);
 
+	m.def("create_texture_pair", &graphics::texture::createPair, //gl.create_texture_pair(front=-1, back=-1, name="");
+		py::arg("front"), py::arg("back"), py::arg("name")="",
+		documentation::texture::createPair
+	);
+
+	m.def("add_texture_pair", &graphics::texture::bindPair, //gl.add_texture_pair(shader=-1, pair=-1, binding=0, side=gl.FRONT, access=gl.AUTO);
+		py::arg("shader"), py::arg("pair"), py::arg("binding"), py::arg("side")=PS_FRONT, py::arg("access")=IA_AUTO,
+		documentation::texture::bindPair
+	);
+
+	m.def("swap", &graphics::texture::swapPair, //gl.swap(pair=-1);
+		py::arg("pair"), documentation::texture::swapPair
+	);
+
+	m.def("delete_texture_pair", &graphics::texture::removePair, //gl.delete_texture_pair(pair=-1);
+		py::arg("pair"), documentation::texture::removePair
+	);
+
+
+
+
+	//Framebuffers
+	m.def("create_framebuffer", &graphics::framebuffer::create, //gl.create_framebuffer(textures=[], depth=True, name="");
+		py::arg("textures"), py::arg("depth")=true, py::arg("name")="",
+		documentation::framebuffer::create
+	);
+
+	m.def("clear_framebuffer", &graphics::framebuffer::clear, //gl.clear_framebuffer(framebuffer=-1, colour=(0.0, 0.0, 0.0, 0.0), depth=1.0);
+		py::arg("framebuffer"), py::arg("colour")=glm::vec4(0.0f, 0.0f, 0.0f, 0.0f), py::arg("depth")=1.0f,
+		documentation::framebuffer::clear
+	);
+
+	m.def("delete_framebuffer", &graphics::framebuffer::remove, //gl.delete_framebuffer(framebuffer=-1);
+		py::arg("framebuffer"), documentation::framebuffer::remove
+	);
+
+
+
+
+	//Meshes
+	m.def("create_mesh", &manageCreateMesh, //gl.create_mesh(format=gl.POS_ONLY, vertices=[], indices=[], optimize=False, packing=gl.PACK_FLOAT, name="");
+		py::arg("format"), py::arg("vertices"), py::arg("indices")=py::list(),
+		py::arg("optimize")=false, py::arg("packing")=VP_FLOAT, py::arg("name")="",
+		documentation::geometry::create
+	);
+	m.def("create_mesh", &manageCreateMeshLayout, //gl.create_mesh(layout, vertices, indices=[], name="");
+		py::arg("layout"), py::arg("vertices"), py::arg("indices")=py::list(), py::arg("name")="",
+		documentation::geometry::createLayout
+	);
+
+	m.def("delete_mesh", &graphics::geometry::remove, //gl.delete_mesh(mesh=-1);
+		py::arg("mesh"), documentation::geometry::remove
+	);
+
 
 
 
@@ -336,6 +1059,11 @@ PYBIND11_MODULE(gl, m) {
 		documentation::matrix::get	
 	);
 
+	m.def("get_model_matrices", &manageModelMatrices, //gl.get_model_matrices(positions, rotations, scales)
+		py::arg("positions"), py::arg("rotations"), py::arg("scales"),
+		documentation::matrix::getModelMatrices
+	);
+
 
 
 
@@ -380,6 +1108,16 @@ PYBIND11_MODULE(gl, m) {
 		py::arg("camera"), documentation::camera::remove
 	);
 
+	m.def("get_camera_matrices", &manageCameraMatrices, //gl.get_camera_matrices(camera);
+		py::arg("camera"), documentation::camera::getMatrices
+	);
+
+
+	m.def("cull", &manageCull, //gl.cull(camera, bounds, mask=False)
+		py::arg("camera"), py::arg("bounds"), py::arg("mask")=false,
+		documentation::camera::cull
+	);
+
 
 
 
@@ -431,6 +1169,40 @@ PYBIND11_MODULE(gl, m) {
 	EXPORT_KEY(F6);				EXPORT_KEY(F7);
 	EXPORT_KEY(F8);				EXPORT_KEY(F9);
 	EXPORT_KEY(F10);			EXPORT_KEY(F11);
-	EXPORT_KEY(F12);
+	EXPORT_KEY(F12);			EXPORT_KEY(F13);
+	EXPORT_KEY(F14);			EXPORT_KEY(F15);
+	EXPORT_KEY(F16);			EXPORT_KEY(F17);
+	EXPORT_KEY(F18);			EXPORT_KEY(F19);
+	EXPORT_KEY(F20);			EXPORT_KEY(F21);
+	EXPORT_KEY(F22);			EXPORT_KEY(F23);
+	EXPORT_KEY(F24);			EXPORT_KEY(F25);
+
+	EXPORT_KEY(GRAVE_ACCENT);	EXPORT_KEY(WORLD_1);
+	EXPORT_KEY(WORLD_2);		EXPORT_KEY(INSERT);
+	EXPORT_KEY(DELETE);			EXPORT_KEY(HOME);
+	EXPORT_KEY(END);			EXPORT_KEY(PAGE_UP);
+	EXPORT_KEY(PAGE_DOWN);		EXPORT_KEY(CAPS_LOCK);
+	EXPORT_KEY(SCROLL_LOCK);	EXPORT_KEY(NUM_LOCK);
+	EXPORT_KEY(PRINT_SCREEN);	EXPORT_KEY(PAUSE);
+	EXPORT_KEY(LEFT_SUPER);		EXPORT_KEY(RIGHT_SUPER);
+	EXPORT_KEY(MENU);
+
+	EXPORT_KEY(KP_0);			EXPORT_KEY(KP_1);
+	EXPORT_KEY(KP_2);			EXPORT_KEY(KP_3);
+	EXPORT_KEY(KP_4);			EXPORT_KEY(KP_5);
+	EXPORT_KEY(KP_6);			EXPORT_KEY(KP_7);
+	EXPORT_KEY(KP_8);			EXPORT_KEY(KP_9);
+	EXPORT_KEY(KP_DECIMAL);		EXPORT_KEY(KP_DIVIDE);
+	EXPORT_KEY(KP_MULTIPLY);	EXPORT_KEY(KP_SUBTRACT);
+	EXPORT_KEY(KP_ADD);			EXPORT_KEY(KP_ENTER);
+	EXPORT_KEY(KP_EQUAL);
+
+	//Mouse buttons & actions, as found in gl.drain_events()
+	m.attr("MOUSE_BUTTON_LEFT") = GLFW_MOUSE_BUTTON_LEFT;
+	m.attr("MOUSE_BUTTON_RIGHT") = GLFW_MOUSE_BUTTON_RIGHT;
+	m.attr("MOUSE_BUTTON_MIDDLE") = GLFW_MOUSE_BUTTON_MIDDLE;
+	m.attr("PRESS") = GLFW_PRESS;
+	m.attr("RELEASE") = GLFW_RELEASE;
+	m.attr("REPEAT") = GLFW_REPEAT;
 }
 //// PYBIND11 STUFF ////
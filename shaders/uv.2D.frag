@@ -6,8 +6,9 @@ out vec4 fragColour;
 
 uniform int testsca;
 uniform vec3 testvec;
+uniform float u_time; //Built-in, set by gl.run()
 
 void main() {
-	//Simply outputs the pixel's screen UV.
-	fragColour = vec4(fragUV.xy, 0.0f, 1.0f);
+	//Simply outputs the pixel's screen UV, with a blue that pulses over time.
+	fragColour = vec4(fragUV.xy, 0.5f + 0.5f*sin(u_time), 1.0f);
 }
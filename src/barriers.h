@@ -0,0 +1,158 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+#include "global.h"
+#include "utils.h"
+
+
+
+//Hazard tracking for memory barriers.
+//Each run gets a serial. Images record the serial of their last write/read, and each access class
+//records the serial of the last barrier covering it. A write is unsynchronised for a class while its
+//serial is newer than that class's barrier, so only the bits a consumer actually needs get issued.
+namespace barriers {
+
+
+//Ways a written image can be consumed, each needs its own barrier bit.
+enum AccessClass {
+	AC_IMAGE,       //imageLoad/imageStore
+	AC_UPDATE,      //Read back/updated by the CPU, e.g. gl.save_texture()
+	AC_FRAMEBUFFER, //Rendered into as an attachment
+	AC_COUNT
+};
+
+constexpr std::array<GLbitfield, AC_COUNT> classBits = {
+	GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+	GL_TEXTURE_UPDATE_BARRIER_BIT,
+	GL_FRAMEBUFFER_BARRIER_BIT
+};
+
+
+inline BarrierMode mode = BM_TRACKED;
+inline uint64_t serial = 0u; //Serial of the current run
+inline std::array<uint64_t, AC_COUNT> lastBarrier = {}; //Serial covered by the last barrier of each class
+inline uint64_t issuedCount = 0u; //Barriers issued since init, for gl.get_barrier_count()
+
+
+//Is there a write to this texture not yet made visible to this access class?
+inline bool pending(const types::Texture& tex, AccessClass ac) {
+	return tex.lastImageWrite > lastBarrier[ac];
+}
+
+
+inline void issue(GLbitfield bits) {
+	if (!bits) {return;}
+	GL_LOG_DEBUG(std::format("Issuing memory barrier [0x{:X}]", bits));
+	glMemoryBarrier(bits);
+	issuedCount++;
+
+	//Covers every run made so far, not the one about to run (beforeRun issues before moving the serial on).
+	for (size_t ac=0; ac<AC_COUNT; ac++) {
+		if (bits & classBits[ac]) {lastBarrier[ac] = serial;}
+	}
+}
+
+
+//Barrier bits needed before a texture can be safely read and/or written as an image.
+//Sampled textures are loaded from files and only ever bound as samplers, no shader writes them.
+inline GLbitfield required(const types::Texture& tex, bool reads, bool writes) {
+	if (!tex.isValid() || tex.sampler2D) {return 0u;}
+
+	//Read after write, or write after an unsynchronised write/read.
+	bool readHazard = reads && pending(tex, AC_IMAGE);
+	bool writeHazard = writes && (pending(tex, AC_IMAGE) || (tex.lastImageRead > lastBarrier[AC_IMAGE]));
+	return (readHazard || writeHazard) ? classBits[AC_IMAGE] : 0u;
+}
+
+//Barrier bits needed before a single binding can be safely used.
+inline GLbitfield required(const types::BoundTexture& bTex) {return required(bTex.resolve(), bTex.reads(), bTex.writes());}
+
+//Barrier bits needed before a shader can safely use all of its bindings.
+inline GLbitfield required(const types::ShaderProgram& shader) {
+	GLbitfield bits = 0u;
+	for (const auto& [binding, bTex] : shader.textures()) {bits |= required(bTex);}
+	return bits;
+}
+
+
+//Checks the bits about to be issued cover every hazard of the access the shader's source declares (not just the
+//access it was added with), and that the added access covers the declared. Must run before those bits are issued.
+inline void verify(const types::ShaderProgram& shader, int shaderID, GLbitfield issuing) {
+	for (const auto& [binding, bTex] : shader.textures()) {
+		const types::Texture& tex = bTex.resolve();
+		if (!tex.isValid() || tex.sampler2D) {continue;}
+
+		ImageAccess source = shader.resolveAccess(binding, IA_AUTO);
+		if (required(tex, source != IA_WRITE, source != IA_READ) & ~issuing) {
+			utils::cerr(std::format(
+				"Barrier hazard : Shader [{}] binding [{}] (\"{}\") would run unsynchronised, it was added with less access than its source uses.",
+				shaderID, binding, tex.name
+			));
+		}
+
+		ImageAccess declared = shader.declaredAccess(binding);
+		bool missedWrite = (declared == IA_WRITE || declared == IA_READ_WRITE) && !bTex.writes();
+		bool missedRead = (declared == IA_READ || declared == IA_READ_WRITE) && !bTex.reads();
+		if (missedWrite || missedRead) {
+			utils::cerr(std::format(
+				"Barrier hazard : Shader [{}] binding [{}] (\"{}\") was added with less access than the shader declares, so its hazards are not tracked.",
+				shaderID, binding, tex.name
+			));
+		}
+	}
+}
+
+
+//Before the shader runs; issue only what it needs.
+//Issued before the serial moves on, so this run's own writes stay newer than the barrier.
+inline void beforeRun(const types::ShaderProgram& shader, int shaderID) {
+	if (mode != BM_ALWAYS) { /* BM_ALWAYS issues after the run instead. */
+		GLbitfield bits = required(shader);
+		if (mode == BM_VERIFY) {verify(shader, shaderID, bits);}
+		issue(bits);
+	}
+	serial++;
+}
+
+
+//After the shader runs; record what it wrote/read.
+inline void afterRun(const types::ShaderProgram& shader, int shaderID) {
+	for (const auto& [binding, bTex] : shader.textures()) {
+		types::Texture& tex = bTex.resolve();
+		if (!tex.isValid() || tex.sampler2D) {continue;}
+
+		if (bTex.writes()) {tex.lastImageWrite = serial; tex.lastWriter = shaderID;}
+		if (bTex.reads()) {tex.lastImageRead = serial;}
+	}
+
+	if (mode == BM_ALWAYS) {
+		issue(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+	}
+}
+
+
+//Before rendering into a framebuffer's textures.
+inline void beforeRender(const types::Framebuffer& target) {
+	GLbitfield bits = 0u;
+	for (const types::Texture* tex : target.colours) {
+		if (tex->isValid() && pending(*tex, AC_FRAMEBUFFER)) {bits |= classBits[AC_FRAMEBUFFER];}
+	}
+	issue(bits);
+}
+
+
+//Before the CPU reads a texture back.
+inline void beforeReadback(const types::Texture& tex) {
+	if (pending(tex, AC_UPDATE)) {issue(classBits[AC_UPDATE]);}
+}
+
+
+//Forget all tracked accesses, e.g. when the context is destroyed.
+inline void reset() {
+	serial = 0u;
+	lastBarrier = {};
+	issuedCount = 0u;
+}
+
+
+}
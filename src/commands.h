@@ -0,0 +1,97 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+#include "global.h"
+#include "utils.h"
+
+
+
+//Recorded command lists.
+//Python records a frame's worth of calls once, every ID/value is checked and cast while recording.
+//gl.submit() then replays the list natively, with none of the per-call binding overhead.
+namespace commands {
+
+
+struct Configure {
+	ShaderType type;
+	bool cull;
+};
+
+struct Run {
+	int shaderID;
+	glm::uvec3 dispatch;
+	int targetID;
+};
+
+struct Uniform {
+	int shaderID;
+	std::string name;
+	types::UniformValue value;
+};
+
+//Uniform computed at replay from the matrices' current state (camera position etc.), multiplied left→right.
+struct MatrixUniform {
+	int shaderID;
+	std::string name;
+	std::vector<MatrixType> matrices;
+	int cameraID;
+	glm::vec3 position, rotation, scale;
+};
+
+struct Bind {
+	int shaderID;
+	int textureID;
+	int binding;
+	ImageAccess access;
+};
+
+struct Swap {
+	int pairID;
+};
+
+struct Barrier {
+	GLbitfield bits;
+};
+
+
+using Command = std::variant<Configure, Run, Uniform, MatrixUniform, Bind, Swap, Barrier>;
+
+
+class CommandList {
+private:
+	bool _valid = false;
+
+public:
+	std::vector<Command> commands;
+	std::string name = "";
+
+	void create(const std::string& n) {
+		name = n;
+		commands.clear();
+		_valid = true;
+	}
+
+	bool isValid() const {return _valid;}
+
+	template <typename T>
+	void record(T&& command) {commands.emplace_back(std::forward<T>(command));}
+
+	void destroy() {
+		commands = {};
+		name = "";
+		_valid = false;
+	}
+};
+
+
+inline size_t numberOfLists = 0u;
+inline std::array<CommandList, constants::misc::MAX_COMMAND_LISTS> lists;
+
+
+inline void reset() {
+	for (CommandList& l : lists) {l.destroy();}
+	numberOfLists = 0u;
+}
+
+
+}
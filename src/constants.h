@@ -44,6 +44,22 @@ enum VAOFormat {
 };
 
 
+//How vertex attributes are stored on the GPU. Input is always float32.
+enum VertexPacking {
+	VP_FLOAT,  //Float32, as given
+	VP_HALF,   //Half float positions & UVs, normalised 16-bit normals
+	VP_COMPACT //Half float positions & UVs, normalised 10:10:10:2 normals
+};
+
+
+//What an attribute holds, which decides how it can be packed
+enum AttributeKind {
+	AK_POSITION,
+	AK_UV,
+	AK_NORMAL
+};
+
+
 //Matrix types to create
 enum MatrixType {
 	MAT_IDENTITY,
@@ -62,61 +78,59 @@ enum CameraDirection {
 };
 
 
+//Sides of a texture pair
+enum PairSide {
+	PS_FRONT, //Read from this pass
+	PS_BACK   //Written to this pass
+};
+
+
+//How a shader accesses an image binding
+enum ImageAccess {
+	IA_AUTO,      //Taken from the shader's readonly/writeonly qualifiers
+	IA_READ,
+	IA_WRITE,
+	IA_READ_WRITE
+};
+
+
+//How memory barriers are issued between shader runs
+enum BarrierMode {
+	BM_TRACKED, //Only the bits a run needs, right before it
+	BM_ALWAYS,  //Image & storage barriers after every run
+	BM_VERIFY   //Tracked, but checks every binding is synchronised and declared correctly
+};
+
+//Kinds of queued input events
+enum InputEventType {
+	IE_KEY,
+	IE_MOUSE_BUTTON,
+	IE_SCROLL
+};
+
+//How the GL context is created
+enum ContextMode {
+	CM_DEBUG,   //Debug context, driver messages collected for gl.get_debug_messages()
+	CM_RELEASE  //No-error context, no validation or debug output
+};
+
+//Where log messages are written
+enum LogSink {
+	LS_STDOUT,
+	LS_FILE,
+	LS_PYTHON  //logging.getLogger("gl")
+};
+
+
 
 
-inline std::unordered_map<int, bool> currentKeyMap = { //GLFW key enums and if they're pressed.
-	{GLFW_KEY_ESCAPE, false},		{GLFW_KEY_SPACE, false},
-	{GLFW_KEY_LEFT_SHIFT, false},	{GLFW_KEY_RIGHT_SHIFT, false},
-	{GLFW_KEY_LEFT_CONTROL, false},	{GLFW_KEY_RIGHT_CONTROL, false},
-	{GLFW_KEY_LEFT_ALT, false},		{GLFW_KEY_RIGHT_ALT, false},
-
-	{GLFW_KEY_1, false},			{GLFW_KEY_2, false},
-	{GLFW_KEY_3, false},			{GLFW_KEY_4, false},
-	{GLFW_KEY_5, false},			{GLFW_KEY_6, false},
-	{GLFW_KEY_7, false},			{GLFW_KEY_8, false},
-	{GLFW_KEY_9, false},			{GLFW_KEY_0, false},
-
-	{GLFW_KEY_Q, false}, 			{GLFW_KEY_W, false},
-	{GLFW_KEY_E, false}, 			{GLFW_KEY_R, false},
-	{GLFW_KEY_T, false}, 			{GLFW_KEY_Y, false},
-	{GLFW_KEY_U, false}, 			{GLFW_KEY_I, false},
-	{GLFW_KEY_O, false}, 			{GLFW_KEY_P, false},
-
-	{GLFW_KEY_A, false},			{GLFW_KEY_S, false},
-	{GLFW_KEY_D, false},			{GLFW_KEY_F, false},
-	{GLFW_KEY_G, false},			{GLFW_KEY_H, false},
-	{GLFW_KEY_J, false},			{GLFW_KEY_K, false},
-	{GLFW_KEY_L, false},			
-									{GLFW_KEY_Z, false},
-	{GLFW_KEY_X, false},			{GLFW_KEY_C, false},
-	{GLFW_KEY_V, false},			{GLFW_KEY_B, false},
-	{GLFW_KEY_N, false},			{GLFW_KEY_M, false},
-
-	{GLFW_KEY_ENTER, false},		{GLFW_KEY_BACKSPACE, false},
-	{GLFW_KEY_TAB, false},			{GLFW_KEY_MINUS, false},
-	{GLFW_KEY_EQUAL, false},		{GLFW_KEY_LEFT_BRACKET, false},
-	{GLFW_KEY_RIGHT_BRACKET, false},{GLFW_KEY_BACKSLASH, false},
-	{GLFW_KEY_SEMICOLON, false},	{GLFW_KEY_APOSTROPHE, false},
-	{GLFW_KEY_COMMA, false},		{GLFW_KEY_PERIOD, false},
-	{GLFW_KEY_SLASH, false},
-									{GLFW_KEY_UP, false},
-	{GLFW_KEY_DOWN, false},			{GLFW_KEY_LEFT, false},
-	{GLFW_KEY_RIGHT, false},
-									{GLFW_KEY_F1, false},
-	{GLFW_KEY_F2, false},			{GLFW_KEY_F3, false},
-	{GLFW_KEY_F4, false},			{GLFW_KEY_F5, false},
-	{GLFW_KEY_F6, false},			{GLFW_KEY_F7, false},
-	{GLFW_KEY_F8, false},			{GLFW_KEY_F9, false},
-	{GLFW_KEY_F10, false},			{GLFW_KEY_F11, false},
-	{GLFW_KEY_F12, false},
-};
-inline std::unordered_map<int, bool> previousKeyMap = currentKeyMap;
 inline glm::dvec2 currentCursorPosition, previousCursorPosition;
 
 
 
 struct Attribute {
 	GLint size;
+	AttributeKind kind;
 };
 
 struct ImageReadFormat {
@@ -152,13 +166,18 @@ namespace constants {
 			{VAO_POS_UV2D_NORMAL, 8u}, {VAO_POS_UV3D_NORMAL, 9u},
 		};
 		static const std::map<VAOFormat, std::vector<Attribute>> layouts = {
-			{VAO_EMPTY,			 	{              }},
-			{VAO_POS_ONLY,		 	{{3},          }},
-			{VAO_POS_UV2D,       	{{3}, {2},     }},
-			{VAO_POS_UV3D,       	{{3}, {3},     }},
-			{VAO_POS_NORMAL,     	{{3}, {3},     }},
-			{VAO_POS_UV2D_NORMAL,	{{3}, {2}, {3},}},
-			{VAO_POS_UV3D_NORMAL,	{{3}, {3}, {3},}},
+			{VAO_EMPTY,			 	{                                             }},
+			{VAO_POS_ONLY,		 	{{3, AK_POSITION},                            }},
+			{VAO_POS_UV2D,       	{{3, AK_POSITION}, {2, AK_UV},                }},
+			{VAO_POS_UV3D,       	{{3, AK_POSITION}, {3, AK_UV},                }},
+			{VAO_POS_NORMAL,     	{{3, AK_POSITION}, {3, AK_NORMAL},            }},
+			{VAO_POS_UV2D_NORMAL,	{{3, AK_POSITION}, {2, AK_UV}, {3, AK_NORMAL},}},
+			{VAO_POS_UV3D_NORMAL,	{{3, AK_POSITION}, {3, AK_UV}, {3, AK_NORMAL},}},
+		};
+
+		static const std::map<ImageAccess, GLenum> imageAccessMap = {
+			{IA_AUTO, GL_READ_WRITE}, {IA_READ, GL_READ_ONLY},
+			{IA_WRITE, GL_WRITE_ONLY}, {IA_READ_WRITE, GL_READ_WRITE},
 		};
 
 		static const std::map<GLint, ImageReadFormat> imgFormatMap = {
@@ -182,11 +201,31 @@ namespace constants {
 	namespace misc {
 		//Access via constants::misc::value
 		constexpr int GL_ERROR_LENGTH = 1024;
-		constexpr bool PAUSE_ON_OPENGL_ERROR = true;
+		constexpr size_t MAX_DEBUG_MESSAGES = 256u; //Distinct GL debug messages kept
 
 		constexpr size_t MAX_SHADERS  = 32u;
 		constexpr size_t MAX_TEXTURES = 64u;
 		constexpr size_t MAX_CAMERAS = 4u;
+		constexpr size_t MAX_TEXTURE_PAIRS = 16u;
+		constexpr size_t MAX_FRAMEBUFFERS = 16u;
+		constexpr size_t MAX_COLOUR_ATTACHMENTS = 8u; //Minimum GL guarantees
+		constexpr size_t MAX_COMMAND_LISTS = 32u;
+		constexpr size_t MAX_MESHES = 256u;
+		constexpr size_t MAX_DRAW_QUEUES = 16u;
+		constexpr size_t FRAME_RING = 240u; //Frames kept for gl.frame_stats()
+		constexpr size_t INPUT_RING = 1024u; //Queued input events, power of 2
+		constexpr size_t LOG_RING = 4096u; //Log messages queued for the sink thread
+		constexpr size_t MAX_TEXTURE_UNITS = 32u; //Units tracked by the state cache, higher ones still work but aren't cached.
+
+		constexpr size_t GPU_TIMER_RING = 4u;      //Timestamp query pairs in flight per shader
+		constexpr size_t GPU_TIMER_SAMPLES = 128u; //Rolling window of GPU times per shader
+		constexpr size_t PROFILER_RING = 1u << 14; //Profiler events kept per thread
+
+		constexpr size_t MAX_WORKER_THREADS = 8u;     //Threads a single batch call may split across
+		constexpr size_t SIMD_MIN_PER_THREAD = 4096u; //Objects per thread before splitting a batch is worth it
+		constexpr size_t MESH_MIN_BYTES_PER_THREAD = 1u << 20; //OBJ text per parsing thread
+		constexpr size_t VERTEX_CACHE_SIZE = 16u;     //FIFO post-transform cache the mesh optimiser targets
+		constexpr float OVERDRAW_THRESHOLD = 1.05f;   //ACMR the overdraw pass may give up, as a multiple
 	}
 
 }
@@ -0,0 +1,138 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+#include "log.h"
+
+#include <mutex>
+
+
+
+//GL debug output, for CM_DEBUG contexts.
+//The driver calls back asynchronously (possibly from its own threads), so the callback only takes a lock
+//and bumps a counter. Repeats of a message are folded into one entry with a count, in first-seen order,
+//and Python collects them with gl.get_debug_messages(). The first of each is also logged.
+namespace gldebug {
+
+
+struct Message {
+	GLuint id = 0u;
+	GLenum source = 0u;
+	GLenum type = 0u;
+	GLenum severity = 0u;
+	std::string text;
+	uint64_t count = 0u;
+};
+
+
+inline std::mutex mutex;
+inline std::vector<Message> messages; //First-seen order
+inline std::unordered_map<uint64_t, size_t> index; //Key → position in messages
+inline uint64_t dropped = 0u; //Distinct messages past MAX_DEBUG_MESSAGES
+
+
+//Ids are only unique per source and type.
+inline uint64_t key(GLenum source, GLenum type, GLuint id) {
+	return (static_cast<uint64_t>(source & 0xFFFFu) << 48) | (static_cast<uint64_t>(type & 0xFFFFu) << 32) | id;
+}
+
+
+inline const char* sourceName(GLenum source) {
+	switch (source) {
+		case GL_DEBUG_SOURCE_API:             {return "API";}
+		case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   {return "Window System";}
+		case GL_DEBUG_SOURCE_SHADER_COMPILER: {return "Shader Compiler";}
+		case GL_DEBUG_SOURCE_THIRD_PARTY:     {return "Third Party";}
+		case GL_DEBUG_SOURCE_APPLICATION:     {return "Application";}
+		default:                              {return "Other";}
+	}
+}
+
+inline const char* typeName(GLenum type) {
+	switch (type) {
+		case GL_DEBUG_TYPE_ERROR:               {return "Error";}
+		case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: {return "Deprecated Behaviour";}
+		case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  {return "Undefined Behaviour";}
+		case GL_DEBUG_TYPE_PORTABILITY:         {return "Portability";}
+		case GL_DEBUG_TYPE_PERFORMANCE:         {return "Performance";}
+		case GL_DEBUG_TYPE_MARKER:              {return "Marker";}
+		case GL_DEBUG_TYPE_PUSH_GROUP:          {return "Push Group";}
+		case GL_DEBUG_TYPE_POP_GROUP:           {return "Pop Group";}
+		default:                                {return "Other";}
+	}
+}
+
+inline const char* severityName(GLenum severity) {
+	switch (severity) {
+		case GL_DEBUG_SEVERITY_HIGH:         {return "high";}
+		case GL_DEBUG_SEVERITY_MEDIUM:       {return "medium";}
+		case GL_DEBUG_SEVERITY_LOW:          {return "low";}
+		default:                             {return "notification";}
+	}
+}
+
+
+inline void APIENTRY callback(
+		GLenum source,
+		GLenum type, GLuint id,
+		GLenum severity,
+		GLsizei length, const GLchar* message,
+		const void* userParam
+	) {
+	//Buffer info/usage notes from NVIDIA, fire on every upload.
+	if(id == 131169 || id == 131185 || id == 131218 || id == 131204) {return;}
+
+	std::string text;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = index.find(key(source, type, id));
+		if (it != index.end()) {messages[it->second].count++; return;}
+
+		if (messages.size() >= constants::misc::MAX_DEBUG_MESSAGES) {dropped++; return;}
+		text = (length >= 0) ? std::string(message, static_cast<size_t>(length)) : std::string(message);
+		index.emplace(key(source, type, id), messages.size());
+		messages.push_back(Message{id, source, type, severity, text, 1u});
+	}
+
+	//First time seen.
+	if (type == GL_DEBUG_TYPE_ERROR) {
+		GL_LOG_MINIMAL(std::format("GL error ({}) [{}, {}] | {}", id, sourceName(source), severityName(severity), text));
+	} else {
+		GL_LOG_DEBUG(std::format("GL debug message ({}) [{}, {}, {}] | {}", id, sourceName(source), typeName(type), severityName(severity), text));
+	}
+}
+
+
+//Turn debug output on for the current context. Needs GL 4.3 or KHR_debug.
+inline bool enable() {
+	if (!(GLEW_KHR_debug || GLEW_VERSION_4_3)) {return false;}
+	glEnable(GL_DEBUG_OUTPUT);
+	glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS); //Let the driver report whenever it likes, rather than stall every call.
+	glDebugMessageCallback(callback, nullptr);
+	glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+	return true;
+}
+
+
+//Copy out (and optionally clear) what's been collected.
+inline std::vector<Message> take(bool clear, uint64_t& lost) {
+	std::lock_guard<std::mutex> lock(mutex);
+	std::vector<Message> out = messages;
+	lost = dropped;
+	if (clear) {
+		messages.clear();
+		index.clear();
+		dropped = 0u;
+	}
+	return out;
+}
+
+
+inline void reset() {
+	std::lock_guard<std::mutex> lock(mutex);
+	messages.clear();
+	index.clear();
+	dropped = 0u;
+}
+
+
+}
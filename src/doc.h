@@ -26,6 +26,10 @@ Intended to simplify the OpenGL process to the higher-level steps such as;
 Py-GLM module reccomended, but not required.
 Any function docstrings that mention taking "vector[int int]" or similar can be assumed as either length-n tuples/lists, or Py-GLM types.
 
+Threading;
+gl.update_window(), gl.load_shader(), gl.load_texture() and gl.save_texture() release the GIL while they block,
+so other Python threads keep running. Anything touching GL objects must still be called from the thread that called gl.init().
+
 
 Requires;
 - OpenGL [3.3 CORE+ / 3.1 ES+]
@@ -37,6 +41,28 @@ Requires;
 //How verbose the module should act (printing to cout)
 inline constexpr const char* verbose = R"doc(
 Configures whether the module can print to console.
+Messages are written by a background thread, so they may show up slightly after the call that made them.
+)doc";
+
+
+//Where log output goes
+inline constexpr const char* logSink = R"doc(
+Sets where the module's log messages are written. Anything still queued is written to the old sink first.
+
+Parameters
+----------
+sink : gl.LogSink
+	gl.LOG_STDOUT (default), gl.LOG_FILE, or gl.LOG_PYTHON to go through logging.getLogger("gl").
+	MINIMAL messages are logged as INFO, DEBUG messages as DEBUG.
+
+path : str
+	File to append to, only used (and required) for gl.LOG_FILE.
+)doc";
+
+
+//Wait for the log
+inline constexpr const char* flushLog = R"doc(
+Blocks until every message logged so far has been written to the sink.
 )doc";
 
 }
@@ -58,11 +84,37 @@ resolution : vector[int, int], optional
 	Resolution of the window to open. If set to (1, 1) or below, window is automatically hidden.
 version : vector[int, int], optional
 	OpenGL version Major|Minor. Assumed as CORE.
+core : bool, optional
+	CORE (True) or ES (False) context.
+headless : bool, optional
+	Create a surfaceless EGL context with no window, rendering into an offscreen framebuffer of size resolution.
+	Needs no display server (Mesa's llvmpipe works), so runs on bare servers/CI.
+	gl.update_window() and gl.poll_events() do nothing in this mode.
+mode : gl.ContextMode, optional
+	gl.CONTEXT_DEBUG (default) creates a debug context and collects driver messages for gl.get_debug_messages().
+	gl.CONTEXT_RELEASE creates a no-error context where supported; the driver skips validation, so GL misuse is undefined.
 
 Raises
 ------
 RuntimeError
-	If GLFW fails to initialise or window fails to open.
+	If GLFW fails to initialise or window fails to open, or the headless context can't be created.
+)doc";
+
+
+//Collected GL debug output
+inline constexpr const char* debugMessages = R"doc(
+Returns the driver's debug messages since the last call, one entry per distinct message with how often it was sent.
+Only collected for gl.CONTEXT_DEBUG contexts on OpenGL 4.3+ (or KHR_debug).
+
+Parameters
+----------
+clear : bool, optional
+	Forget the returned messages, so the next call only has new ones.
+
+Returns
+-------
+list[dict]
+	In the order first seen. Keys: "id", "source", "type", "severity", "message", "count".
 )doc";
 
 
@@ -86,6 +138,7 @@ bool
 //Check if key was pressed
 inline constexpr const char* wasKeyPressed = R"doc(
 If key has been pressed since the last gl.poll_events() call.
+Taps shorter than a frame count too, they show as both pressed and released.
 
 Parameters
 ----------
@@ -131,9 +184,90 @@ bool
 )doc";
 
 
+//Zero-copy input state
+inline constexpr const char* inputSnapshot = R"doc(
+Read-only NumPy views of the whole input state. gl.poll_events() refreshes them in place,
+so call this once, keep the arrays, and read them every frame without any further calls or allocations.
+They aren't locked, so only call this and read them from the thread that called gl.init().
+
+Returns
+-------
+dict[str, numpy.ndarray]
+	"held", "pressed", "released" : bool arrays indexed by KEY_* value. pressed/released are since the last poll.
+	"mouse_held", "mouse_pressed", "mouse_released" : bool arrays indexed by MOUSE_BUTTON_* value.
+	"cursor", "cursor_delta" : float64 [x, y] cursor position and its movement over the last poll, in pixels.
+	"scroll" : float64 [x, y] scroll offset summed over the last poll.
+)doc";
+
+
+//Queued input events
+inline constexpr const char* drainEvents = R"doc(
+Takes every key, mouse button and scroll event queued since the last call, in the order they happened.
+Unlike gl.was_key_pressed(), nothing between polls is merged, so fast input keeps its exact timing.
+The queue holds up to 1024 events, drain it every frame.
+
+Returns
+-------
+list[tuple[gl.InputEventType, float, int, int, int, float, float]]
+	(type, time, code, action, mods, x, y) per event, oldest first.
+	time is in seconds on GLFW's clock. code is the KEY_*/MOUSE_BUTTON_* value, action is PRESS/RELEASE/REPEAT.
+	x, y are the cursor position for mouse buttons, or the offset for scrolling.
+)doc";
+
+
 //Update buffers etc
 inline constexpr const char* update = R"doc(
 Updates the window's framebuffer and other systems.
+Also ends the frame for gl.frame_stats(), and waits out the frame limit if one is set.
+)doc";
+
+
+//Vsync
+inline constexpr const char* swapInterval = R"doc(
+Sets how many monitor refreshes gl.update_window() waits for before swapping (vsync).
+Without this, the driver's default is used.
+
+Parameters
+----------
+interval : int, optional
+	0 swaps immediately (uncapped), 1 waits for every refresh, 2 every other, etc.
+	-1 is adaptive vsync; late frames swap immediately instead of waiting for the next refresh.
+	Falls back to 1 if the driver doesn't support it.
+)doc";
+
+
+//Sleep-based frame cap
+inline constexpr const char* frameLimit = R"doc(
+Caps the frame rate by sleeping in gl.update_window(), rather than spinning a core when uncapped.
+
+Parameters
+----------
+fps : float, optional
+	Maximum frames per second. 0 disables the limiter.
+
+Raises
+------
+RuntimeError
+	If the frame rate is negative, or called from a thread other than gl.init()'s.
+)doc";
+
+
+//Frame pacing stats
+inline constexpr const char* frameStats = R"doc(
+Statistics of the last frames' times, from one gl.update_window() returning to the next.
+Safe to call from any thread, even while gl.update_window() runs on the context thread.
+
+Parameters
+----------
+reset : bool, optional
+	Whether to forget the recorded frames after reading them.
+
+Returns
+-------
+dict[str, float]
+	{"frames", "mean_ms", "p50_ms", "p99_ms", "target_ms", "missed"}.
+	"target_ms" is the frame time expected from vsync/the limiter, 0 if unknown.
+	"missed" counts frames taking over 1.5x that target.
 )doc";
 
 
@@ -227,6 +361,18 @@ VAOFormat
 )doc";
 
 
+//How vertices are stored on the GPU
+inline constexpr const char* VertexPacking = R"doc(
+VertexPacking
+-------------
+- VertexPacking.PACK_FLOAT   : Every value as a 32-bit float, as given.
+- VertexPacking.PACK_HALF    : Positions and UVs as half floats, normals as normalised 16-bit integers. About half the size.
+- VertexPacking.PACK_COMPACT : Positions and UVs as half floats, normals as normalised 10:10:10:2 in one 32-bit integer.
+Shaders read the same vec2/vec3 inputs whichever is used. Half floats keep 11 bits of precision and top out at 65504,
+so PACK_HALF/PACK_COMPACT suit meshes kept in model space near the origin, scaled up by the model matrix.
+)doc";
+
+
 //Types of matrix
 inline constexpr const char* MatrixType = R"doc(
 MatrixType
@@ -249,6 +395,65 @@ CameraDirection
 )doc";
 
 
+//Sides of a texture pair
+inline constexpr const char* PairSide = R"doc(
+PairSide
+----------
+- PairSide.FRONT : The side read from this pass. Becomes the back after gl.swap().
+- PairSide.BACK  : The side written to this pass. Becomes the front after gl.swap().
+)doc";
+
+
+//How shaders access image bindings
+inline constexpr const char* ImageAccess = R"doc(
+ImageAccess
+----------
+- ImageAccess.AUTO       : Use the binding's readonly/writeonly qualifiers in the shader source. Read/write if it has neither.
+- ImageAccess.READ       : The shader only reads this image.
+- ImageAccess.WRITE      : The shader only writes this image.
+- ImageAccess.READ_WRITE : The shader reads and writes this image.
+)doc";
+
+
+//Kinds of input event
+inline constexpr const char* InputEventType = R"doc(
+InputEventType
+--------------
+- InputEventType.EVENT_KEY          : A key was pressed, released or repeated.
+- InputEventType.EVENT_MOUSE_BUTTON : A mouse button was pressed or released.
+- InputEventType.EVENT_SCROLL       : The scroll wheel/trackpad moved.
+)doc";
+
+
+//Context creation modes
+inline constexpr const char* ContextMode = R"doc(
+ContextMode
+-----------
+- ContextMode.CONTEXT_DEBUG   : Debug context, driver messages are collected for gl.get_debug_messages().
+- ContextMode.CONTEXT_RELEASE : No-error context, the driver skips validation and sends no messages.
+)doc";
+
+
+//Log destinations
+inline constexpr const char* LogSink = R"doc(
+LogSink
+-------
+- LogSink.LOG_STDOUT : Print to the console (default).
+- LogSink.LOG_FILE   : Append to a file.
+- LogSink.LOG_PYTHON : Pass to Python's logging module, as logger "gl".
+)doc";
+
+
+//How memory barriers are issued between runs
+inline constexpr const char* BarrierMode = R"doc(
+BarrierMode
+----------
+- BarrierMode.BARRIER_TRACKED : Tracks which images each run writes, and only issues the barriers a later run needs, right before it.
+- BarrierMode.BARRIER_ALWAYS  : Issues image & storage barriers after every run.
+- BarrierMode.BARRIER_VERIFY  : As BARRIER_TRACKED, but raises if a binding's hazards wouldn't be synchronised for the access its shader source has (unqualified images are read-write), or it was added with less access than the shader declares.
+)doc";
+
+
 }
 
 
@@ -308,6 +513,15 @@ Raises
 ------
 RuntimeError
 	If this shader index is not valid.
+
+Notes
+-----
+Some values never need adding, declaring them in the shader is enough. They are set on every gl.run():
+	float u_time             Seconds since gl.init().
+	int/uint u_frame         Number of gl.update_window() calls since gl.init().
+	vec2/ivec2 u_resolution  Size of the framebuffer being rendered into (the window, unless target is given).
+	mat4 u_viewProj[N]       projection * view of camera IDs 0 to N-1 at u_resolution's aspect ratio (identity for IDs with no camera).
+A value added here under one of these names overrides the built-in.
 )doc";
 
 
@@ -323,11 +537,109 @@ format : VAOFormat
 	The format of the data. See docs for VAOFormat for the formats.
 values : list[float]
 	A dataset of floating point values to be used in the shader's VAO.
+indices : list[int], optional
+	Triangles, as 3 vertex indices each. Stored as 16-bit on the GPU if there are at most 65536 vertices.
+optimize : bool, optional
+	Reorder triangles and vertices for the GPU's vertex cache, overdraw and vertex fetch before uploading,
+	see gl.optimize_mesh(). The ACMR before and after is logged.
+packing : VertexPacking, optional
+	How the vertices are stored on the GPU, see VertexPacking. Values are always given as floats.
 
 Raises
 ------
 RuntimeError
-	If this shader index is not valid.
+	If this shader index is not valid, an index is past the vertices given, or a value doesn't fit the packing.
+)doc";
+
+
+//Adds a VAO with a custom layout to this shader.
+inline constexpr const char* addVAOLayout = R"doc(
+Adds vertices to a 3D shader in any layout, for attributes beyond position/UV/normal (colours, tangents, bone weights, ...).
+Buffers are uploaded as they are, nothing is converted. Each attribute goes to layout(location=N) in the vertex shader.
+
+Parameters
+----------
+shader : int
+	Shader index to assign to.
+layout : numpy.dtype | list[tuple | numpy.dtype]
+	Either a structured dtype, one attribute per field at locations 0, 1, 2..., or a list of
+	(location, components, type, normalised, offset[, stream]) tuples, or a list of structured dtypes, one per stream.
+	type is a numpy dtype (float16/32, (u)int8/16/32), or "int_2_10_10_10_rev"/"uint_2_10_10_10_rev" with 4 components.
+	Integer types that aren't normalised are read as ints (in ivecN/uvecN). From a dtype, 8/16-bit integer fields are
+	normalised and 32-bit ones are read as ints.
+vertices : numpy.ndarray | list[numpy.ndarray]
+	One interleaved buffer, or one per stream (vertex buffer binding), each with the same number of vertices.
+	The vertex size is a row of an (N, ...) or structured array; a flat array is taken as tightly packed.
+indices : list[int], optional
+	Triangles, as 3 vertex indices each. Stored as 16-bit on the GPU if there are at most 65536 vertices.
+
+Raises
+------
+RuntimeError
+	If the shader index is invalid, an attribute doesn't fit its stream or GL's limits, the streams' vertex counts differ,
+	or an index is past the vertices given.
+)doc";
+
+
+//Loads a mesh file as this shader's VAO.
+inline constexpr const char* loadMesh = R"doc(
+Loads a mesh file straight into a 3D shader's vertices, replacing anything added with gl.add_vao().
+The file is parsed natively (OBJ on several threads), with identical corners merged into one indexed vertex.
+The VAOFormat is picked from what the file has: VAO_POS_ONLY, VAO_POS_UV2D, VAO_POS_NORMAL or VAO_POS_UV2D_NORMAL.
+
+Parameters
+----------
+shader : int
+	Shader index to assign to.
+file_path : str
+	Path to a .obj (polygons are fanned into triangles) or a binary glTF .glb.
+	From a .glb, every triangle primitive of every mesh is merged, without applying node transforms.
+optimize : bool, optional
+	Reorder triangles and vertices for the GPU before uploading, see gl.optimize_mesh().
+packing : VertexPacking, optional
+	How the vertices are stored on the GPU, see VertexPacking.
+
+Raises
+------
+RuntimeError
+	If the shader index is invalid, the file can't be read or parsed, or a value doesn't fit the packing.
+
+Returns
+-------
+dict
+	"format" (VAOFormat), "vertices" and "indices" (counts), "bounds_min"/"bounds_max" as glm.vec3,
+	and "acmr_before"/"acmr_after" (the same unless optimised).
+)doc";
+
+
+//Optimises a mesh without uploading it.
+inline constexpr const char* optimizeMesh = R"doc(
+Reorders a triangle mesh for the GPU, returning the new buffers. The same triangles are drawn, with the same winding.
+	1. Triangles are reordered so vertices are reused while still in the post-transform cache (Tipsify).
+	2. That order is cut into clusters where it costs little (at most 5% more cache misses), and the clusters facing
+	   out from the mesh's centre are drawn first, so fewer hidden fragments get shaded.
+	3. Vertices are renumbered in order of first use, unused ones dropped, so vertex fetches walk memory forwards.
+Worth doing once for generated or loaded meshes, e.g. before saving them, rather than every frame.
+
+Parameters
+----------
+format : VAOFormat
+	Layout of each vertex. Positions come first in every format.
+vertices : numpy.ndarray | list[float]
+	Vertex values, flat or (N, floats per vertex).
+indices : numpy.ndarray | list[int]
+	Triangles, as 3 vertex indices each.
+
+Raises
+------
+RuntimeError
+	If the format has no positions, vertices doesn't fit the format, or an index is out of range.
+
+Returns
+-------
+dict
+	"vertices" (N, floats per vertex) float32 and "indices" uint32 arrays, and "acmr_before"/"acmr_after":
+	the average cache miss ratio (vertices transformed per triangle, 16-entry FIFO cache), 3.0 worst, ~0.5 best.
 )doc";
 
 
@@ -341,11 +653,100 @@ shader : int
 	Shader index to assign to.
 dispatch : list[int, int, int], optional
 	Number of X/Y/Z threads to dispatch, only used if the shader is ST_COMPUTE type.
+target : int, optional
+	Framebuffer (from gl.create_framebuffer()) to render into. -1 renders to the screen. Not used by ST_COMPUTE.
+mesh : int, optional
+	Mesh (from gl.create_mesh()) to draw instead of the shader's own vertices. ST_WORLDSPACE only.
 
 Raises
 ------
 RuntimeError
-	If this shader index is not valid.
+	If this shader or mesh index is not valid.
+)doc";
+
+
+//Draws many meshes with one shader.
+inline constexpr const char* draw = R"doc(
+Draws several meshes with one ST_WORLDSPACE shader. The program, textures and uniforms are set once,
+then each mesh only switches the VAO and issues its draw, so it's much cheaper than a gl.run() per mesh.
+
+Parameters
+----------
+shader : int
+	Index of the ST_WORLDSPACE shader to draw with.
+meshes : list[int]
+	Meshes (from gl.create_mesh()) to draw, in order. An empty list draws nothing.
+target : int, optional
+	Framebuffer (from gl.create_framebuffer()) to render into. -1 renders to the screen.
+
+Raises
+------
+RuntimeError
+	If the shader isn't ST_WORLDSPACE, or any index is invalid.
+)doc";
+
+
+//Timing shader runs on the GPU
+inline constexpr const char* enableGPUTiming = R"doc(
+Enables/disables GPU timing of each gl.run() call, using timestamp queries.
+Results are read back a few runs later, once available, so timing never stalls the GPU.
+
+Parameters
+----------
+enabled : bool, optional
+	Whether runs should be timed.
+)doc";
+
+
+//Reading GPU times back
+inline constexpr const char* getGPUTimings = R"doc(
+Returns the recent GPU time of each shader that has been timed (see gl.enable_gpu_timing()).
+Only reads results that have already finished, so it does not wait on the GPU.
+
+Returns
+-------
+dict[int, dict]
+	Shader index → {"name", "samples", "mean_us", "min_us", "max_us", "p95_us"}, over the last samples of that shader. Times in microseconds.
+)doc";
+
+
+//State cache counters
+inline constexpr const char* stateStats = R"doc(
+How many GL state changes (capabilities, depth state, program, VAO, framebuffer, texture/image units)
+reached the driver last frame, and how many were skipped for already being set.
+
+Returns
+-------
+dict[str, int]
+	{"issued", "skipped"}, for the last frame ended by gl.update_window().
+
+Raises
+------
+RuntimeError
+	If called from a thread other than gl.init()'s.
+)doc";
+
+
+//Choosing how memory barriers are issued
+inline constexpr const char* barrierMode = R"doc(
+Sets how memory barriers are issued between shader runs.
+By default, only the barriers needed by images a run reads/writes are issued, right before that run.
+
+Parameters
+----------
+mode : BarrierMode
+	See (BarrierMode) for the modes.
+)doc";
+
+
+//Counting memory barriers
+inline constexpr const char* barrierCount = R"doc(
+How many memory barriers have been issued since gl.init(), by runs, command lists and texture reads.
+
+Returns
+-------
+int
+	Number of glMemoryBarrier() calls made.
 )doc";
 
 
@@ -418,6 +819,10 @@ shader : int
 	Which shader (by index) to apply it to.
 texture : int
 	The index of the texture to add.
+binding : int
+	The binding/unit to use in the shader.
+access : ImageAccess, optional
+	How the shader accesses this image, used to place memory barriers. See (ImageAccess).
 
 Raises
 ------
@@ -459,110 +864,766 @@ RuntimeError
 	If the index was invalid.
 )doc";
 
-}
-
-
 
-//Matrix functions
-namespace matrix {
-
-//Gets/creates a matrix of given type.
-inline constexpr const char* get = R"doc(
-Creates a perspective projection matrix from the selected camera index.
-Perspective matrices cause objects to get smaller with distance.
+//Pairs 2 textures for double-buffering.
+inline constexpr const char* createPair = R"doc(
+Pairs 2 textures as a front/back double-buffer, for passes that read one and write the other.
+Both textures must have the same resolution and format.
 
 Parameters
 ----------
-type : MatrixType
-	Type of matrix to create: [MAT_IDENTITY, MAT_PERSPECTIVE, MAT_ORTHOGRAPHIC, MAT_VIEW, MAT_MODEL].
-camera : int, optional
-	Index of the camera to create the matrix from. Only required for [MAT_PERSPECTIVE, MAT_VIEW].
-position : vector[float, float, float], optional
-	Translation of the matrix. Only required for [MAT_MODEL].
-rotation : vector[float, float, float], optional
-	Rotation of the matrix around its origin. Only required for [MAT_MODEL].
-scale : vector[float, float, float], optional
-	Scale of the matrix relative to its origin. Only required for [MAT_MODEL].
+front : int
+	Index of the texture that starts as the front (read) side.
+back : int
+	Index of the texture that starts as the back (write) side.
+name : str, optional
+	Name of the pair, for debugging.
+
+Returns
+-------
+int
+	The index of this new texture pair.
 
 Raises
 ------
 RuntimeError
-	For unknown type.
-
-Returns
--------
-tuple[tuple[float]]
-	A 4x4 2D matrix of tuples representing a matrix. Can be converted to a py-glm mat4 directly.
+	If either texture is invalid, they differ in resolution/format, or maximum texture pair count was reached.
 )doc";
 
-}
-
-
-
-//Camera functions
-namespace camera {
 
-//Assign new camera.
-inline constexpr const char* newCamera = R"doc(
-Creates a new camera, returning the ID of this new camera.
+//Adds one side of a pair to a shader's list to be bound at runtime.
+inline constexpr const char* bindPair = R"doc(
+Adds one side of a texture pair to a shader. The side is resolved each time the shader is run,
+so it follows the pair through gl.swap() without being re-added.
 
 Parameters
 ----------
-position : vector[float, float, float], optional
-	3D Position to start the camera at.
-angle : vector[float, float, float], optional
-	Yaw/Pitch/Roll to start the camera at.
-up : vector[float, float, float], optional
-	Up-direction of the camera. By default, +Z upwards.
-fov_deg : float
-	Field of view, in degrees. Automatically converted to radians.
-fov_rad : float
-	Field of View, in radians. Preferred over fov_deg if both are present.
-near_z : float
-	The distance from the camera (World units) the closest objects rendered are allowed to be.
-far_z : float
-	The distance from the camera (World units) the furthest objects rendered are allowed to be.
+shader : int
+	Which shader (by index) to apply it to.
+pair : int
+	The index of the texture pair to add.
+binding : int
+	The binding/unit to use in the shader.
+side : PairSide, optional
+	Which side of the pair to bind. See (PairSide).
+access : ImageAccess, optional
+	How the shader accesses this image, used to place memory barriers. See (ImageAccess).
 
 Raises
 ------
 RuntimeError
-	If there are already too many cameras created, or if the up-direction is invalid.
-
-Returns
--------
-int
-	Index of the new camera. Used when modifying its data later, or when using it to create matrices.
+	If the shader or pair ID were invalid.
 )doc";
 
 
-//Keeps the doc the same for "forward", "right" and "up" using std::format.
-inline constexpr const char* getDir = R"doc(
-Returns the current ?-direction of a camera from its ID.
+//Swaps the front/back of a pair.
+inline constexpr const char* swapPair = R"doc(
+Swaps the front and back of a texture pair. No data is copied and nothing is re-bound;
+every shader using this pair sees the new sides on its next run.
 
 Parameters
 ----------
-camera : int
-	The ID of the camera to access.
-direction : CameraDirection
-	The direction to read from this camera. Uses the CameraDirection enum.
+pair : int
+	The index of the texture pair to swap.
 
-
-Returns
--------
-vector[float, float float]
-	The camera's ?-direction.
+Raises
+------
+RuntimeError
+	If the pair ID was invalid.
 )doc";
 
 
-inline constexpr const char* newPos = R"doc(
-Sets a new camera position (X/Y/Z | Up-direction depends on camera UP → Can be got via `gl.camera_up(camera=ID))`.) for a camera by its ID.
+//"Deletes" a texture pair.
+inline constexpr const char* removePair = R"doc(
+Deletes a texture pair. The textures it was made of are left untouched.
 
 Parameters
 ----------
-camera : int
-	The ID of the camera to edit.
-position : vector[float, float, float], optional
-	3D Position to start the camera at.
+pair : int
+	The texture pair to remove/"delete".
+
+Raises
+------
+RuntimeError
+	If the index was invalid.
+)doc";
+
+}
+
+
+
+//Recorded command lists
+namespace commandList {
+
+//New command list.
+inline constexpr const char* create = R"doc(
+Creates an empty command list. Record a frame's calls into it once, then replay them all with gl.submit().
+Every ID and value is checked while recording, so replaying skips the per-call Python overhead.
+
+Parameters
+----------
+name : str, optional
+	Name of the command list, for debugging.
+
+Returns
+-------
+int
+	The index of this new command list.
+
+Raises
+------
+RuntimeError
+	If the maximum command list count was reached.
+)doc";
+
+
+//Record gl.configure()
+inline constexpr const char* recordConfigure = R"doc(
+Records a gl.configure() call.
+
+Parameters
+----------
+list : int
+	Command list to record into.
+type : gl.ShaderType
+	Type of shader to configure for.
+cull : bool, optional
+	Whether to cull back faces (ShaderType.WORLDSPACE only).
+
+Raises
+------
+RuntimeError
+	If the list or type is invalid.
+)doc";
+
+
+//Record gl.run()
+inline constexpr const char* recordRun = R"doc(
+Records a gl.run() call.
+
+Parameters
+----------
+list : int
+	Command list to record into.
+shader : int
+	Shader to run.
+dispatch : list[int, int, int], optional
+	Number of X/Y/Z threads to dispatch, only used if the shader is ST_COMPUTE type.
+target : int, optional
+	Framebuffer to render into. -1 renders to the screen.
+
+Raises
+------
+RuntimeError
+	If the list, shader or framebuffer is invalid.
+)doc";
+
+
+//Record gl.add_uniform_value()
+inline constexpr const char* recordUniform = R"doc(
+Records a gl.add_uniform_value() call. The value is copied now, later changes to the Python object are not seen.
+
+Parameters
+----------
+list : int
+	Command list to record into.
+shader : int
+	Shader to set the uniform of.
+name : str
+	Name of the uniform.
+value : int | float | bool | glm.vec* | glm.mat3 | glm.mat4
+	Value to set.
+
+Raises
+------
+RuntimeError
+	If the list or shader is invalid, or the value's type is unsupported.
+)doc";
+
+
+//Record a uniform that is recomputed at submit time.
+inline constexpr const char* recordMatrixUniform = R"doc(
+Records a mat4 uniform that is computed again on every gl.submit(), from the current camera state.
+The matrices are multiplied left to right, e.g. [gl.PERSPECTIVE, gl.VIEW, gl.MODEL] gives a PVM matrix.
+
+Parameters
+----------
+list : int
+	Command list to record into.
+shader : int
+	Shader to set the uniform of.
+name : str
+	Name of the uniform.
+matrices : list[gl.MatrixType]
+	Matrices to multiply, as in gl.get_matrix().
+camera : int, optional
+	Camera used by PERSPECTIVE/VIEW matrices.
+position, rotation, scale : vector[float, float, float], optional
+	Used by MODEL matrices.
+
+Raises
+------
+RuntimeError
+	If the list, shader or camera is invalid, or no matrices were given.
+)doc";
+
+
+//Record gl.add_texture()
+inline constexpr const char* recordBind = R"doc(
+Records a gl.add_texture() call.
+
+Parameters
+----------
+list : int
+	Command list to record into.
+shader : int
+	Shader to bind the texture to.
+texture : int
+	Texture to bind.
+binding : int
+	Binding point, matching `layout(binding=N)` in the shader.
+access : gl.ImageAccess, optional
+	How the shader accesses the image.
+
+Raises
+------
+RuntimeError
+	If the list, shader or texture is invalid.
+)doc";
+
+
+//Record gl.swap()
+inline constexpr const char* recordSwap = R"doc(
+Records a gl.swap() call.
+
+Parameters
+----------
+list : int
+	Command list to record into.
+pair : int
+	Texture pair to swap.
+
+Raises
+------
+RuntimeError
+	If the list or texture pair is invalid.
+)doc";
+
+
+//Record a full barrier
+inline constexpr const char* recordBarrier = R"doc(
+Records a full memory barrier (all bits). Barriers between runs are normally tracked automatically,
+this is only needed for accesses the tracker can't see.
+
+Parameters
+----------
+list : int
+	Command list to record into.
+
+Raises
+------
+RuntimeError
+	If the list is invalid.
+)doc";
+
+
+//Replay a list
+inline constexpr const char* submit = R"doc(
+Replays every recorded command, in order, in one call.
+
+Parameters
+----------
+list : int
+	Command list to replay.
+
+Returns
+-------
+bool
+	Whether every run succeeded.
+
+Raises
+------
+RuntimeError
+	If the list is invalid, or a recorded framebuffer has since been deleted.
+)doc";
+
+
+//Empty a list
+inline constexpr const char* clear = R"doc(
+Removes every recorded command, keeping the list itself for re-recording.
+
+Parameters
+----------
+list : int
+	Command list to clear.
+
+Raises
+------
+RuntimeError
+	If the list is invalid.
+)doc";
+
+
+//"Deletes" a list
+inline constexpr const char* remove = R"doc(
+Deletes a command list.
+
+Parameters
+----------
+list : int
+	The command list to remove/"delete".
+
+Raises
+------
+RuntimeError
+	If the index was invalid.
+)doc";
+
+}
+
+
+
+//Sorted draw queues
+namespace drawQueue {
+
+//New draw queue.
+inline constexpr const char* create = R"doc(
+Creates an empty draw queue. Queue a frame's draws in any order with gl.queue_draw(), then gl.flush_draw_queue()
+sorts and draws them, so draws sharing a target, shader, textures & mesh only set that state once.
+
+Parameters
+----------
+name : str, optional
+	Name of the draw queue, for debugging.
+
+Returns
+-------
+int
+	The index of this new draw queue.
+
+Raises
+------
+RuntimeError
+	If the maximum draw queue count was reached.
+)doc";
+
+
+//Queue one draw
+inline constexpr const char* submit = R"doc(
+Queues one draw of a worldspace shader, to be drawn on the next gl.flush_draw_queue().
+Opaque draws are grouped by target, shader, textures then mesh, and drawn front to back (nearest first) within
+each group. Transparent draws come after every opaque draw of their target, back to front.
+Per-draw textures & uniforms only apply to their draw, the shader's own are put back for its draws without them.
+
+Parameters
+----------
+queue : int
+	Draw queue to add to.
+shader : int
+	Worldspace shader to draw with, its own textures & uniforms apply as in gl.run().
+mesh : int, optional
+	Mesh to draw, from gl.create_mesh(). -1 draws the shader's own vertices (gl.add_vao()).
+target : int, optional
+	Framebuffer to render into. -1 renders to the screen.
+textures : dict[int, int], optional
+	{binding : texture ID} sampled textures for this draw only. Images must be bound with gl.add_texture().
+uniforms : dict[str, int | float | bool | glm.vec* | glm.mat3 | glm.mat4], optional
+	Uniforms for this draw only, set after the shader's own. Copied now, names the shader lacks are ignored.
+depth : float, optional
+	Distance from the camera, used for the order within a group. Negative values count as 0.
+transparent : bool, optional
+	Whether to draw back to front after the opaque draws.
+
+Raises
+------
+RuntimeError
+	If the queue, shader, mesh, framebuffer or a texture is invalid, or a uniform's type is unsupported.
+)doc";
+
+
+//Sort & draw a queue
+inline constexpr const char* flush = R"doc(
+Sorts the queued draws by their keys, draws them changing only the state that differs from the draw before, then
+empties the queue. Draws with identical keys keep the order they were queued in.
+
+Parameters
+----------
+queue : int
+	Draw queue to flush.
+
+Returns
+-------
+dict
+	{"draws", "switches", "unsorted", "avoided", "targets", "programs", "textures", "meshes"}
+	"switches" is the state changes made, split into "targets", "programs", "textures" and "meshes".
+	"unsorted" is how many drawing in queued order would have made, "avoided" the difference.
+
+Raises
+------
+RuntimeError
+	If the queue is invalid, or a queued shader, mesh, framebuffer or texture has since been deleted.
+)doc";
+
+
+//Empty a queue
+inline constexpr const char* clear = R"doc(
+Removes every queued draw without drawing them.
+
+Parameters
+----------
+queue : int
+	Draw queue to clear.
+
+Raises
+------
+RuntimeError
+	If the queue is invalid.
+)doc";
+
+
+//"Deletes" a queue
+inline constexpr const char* remove = R"doc(
+Deletes a draw queue.
+
+Parameters
+----------
+queue : int
+	The draw queue to remove/"delete".
+
+Raises
+------
+RuntimeError
+	If the index was invalid.
+)doc";
+
+}
+
+
+
+//Framebuffers (render targets)
+namespace framebuffer {
+
+//Create a render target from textures.
+inline constexpr const char* create = R"doc(
+Creates a framebuffer that renders into existing textures, for use as gl.run(target=...).
+Texture N receives the fragment shader's `layout(location=N) out` value, so one pass can write several outputs.
+The textures can still be used as samplers/images by other shaders, no copies are made.
+
+Parameters
+----------
+textures : list[int]
+	Indices of the colour textures, in attachment order. All must share a resolution.
+depth : bool, optional
+	Whether to add a depth buffer, for ShaderType.WORLDSPACE passes.
+name : str, optional
+	Name of the framebuffer, for debugging.
+
+Returns
+-------
+int
+	The index of this new framebuffer.
+
+Raises
+------
+RuntimeError
+	If a texture is invalid, resolutions differ, too many textures were given, or maximum framebuffer count was reached.
+)doc";
+
+
+//Clear a render target.
+inline constexpr const char* clear = R"doc(
+Clears every colour texture of a framebuffer, and its depth buffer if it has one.
+
+Parameters
+----------
+framebuffer : int
+	Index of the framebuffer to clear.
+colour : vector[float, float, float, float], optional
+	Value to clear the colour textures to.
+depth : float, optional
+	Value to clear the depth buffer to.
+
+Raises
+------
+RuntimeError
+	If the framebuffer index is invalid.
+)doc";
+
+
+//"Deletes" a render target.
+inline constexpr const char* remove = R"doc(
+Deletes a framebuffer. The textures it rendered into are left untouched.
+
+Parameters
+----------
+framebuffer : int
+	The framebuffer to remove/"delete".
+
+Raises
+------
+RuntimeError
+	If the index was invalid.
+)doc";
+
+}
+
+
+
+//Meshes, drawn by any worldspace shader
+namespace geometry {
+
+//Create a mesh from a VAOFormat.
+inline constexpr const char* create = R"doc(
+Uploads vertices as a mesh of their own, not tied to a shader. Any ST_WORLDSPACE shader can draw it with
+gl.run(shader, mesh=...) or gl.draw(shader, [...]), so one shader can draw many meshes.
+Takes the same values as gl.add_vao().
+
+Parameters
+----------
+format : VAOFormat
+	The format of the data. See docs for VAOFormat for the formats.
+vertices : numpy.ndarray | list[float]
+	Vertex values, flat or (N, floats per vertex).
+indices : list[int], optional
+	Triangles, as 3 vertex indices each.
+optimize : bool, optional
+	Reorder triangles and vertices for the GPU before uploading, see gl.optimize_mesh().
+packing : VertexPacking, optional
+	How the vertices are stored on the GPU, see VertexPacking.
+name : str, optional
+	Name of the mesh, for debugging.
+
+Returns
+-------
+int
+	The index of this new mesh.
+
+Raises
+------
+RuntimeError
+	If the format is VAO_EMPTY, the vertices don't fit it, or maximum mesh count was reached.
+)doc";
+
+
+//Create a mesh from a custom layout.
+inline constexpr const char* createLayout = R"doc(
+Uploads vertices in a custom layout as a mesh of their own. Takes the same layouts & buffers as gl.add_vao(shader, layout, ...).
+
+Parameters
+----------
+layout : numpy.dtype | list[tuple | numpy.dtype]
+	Structured dtype, or list of (location, components, type, normalised, offset[, stream]) tuples or dtypes.
+vertices : numpy.ndarray | list[numpy.ndarray]
+	One interleaved buffer, or one per stream.
+indices : list[int], optional
+	Triangles, as 3 vertex indices each.
+name : str, optional
+	Name of the mesh, for debugging.
+
+Returns
+-------
+int
+	The index of this new mesh.
+
+Raises
+------
+RuntimeError
+	If the layout doesn't fit the buffers, or maximum mesh count was reached.
+)doc";
+
+
+//"Deletes" a mesh.
+inline constexpr const char* remove = R"doc(
+Deletes a mesh, freeing its GPU buffers.
+
+Parameters
+----------
+mesh : int
+	The mesh to remove/"delete".
+
+Raises
+------
+RuntimeError
+	If the index was invalid.
+)doc";
+
+}
+
+
+
+//CPU/GPU profiling
+namespace profile {
+
+//Toggle the profiler.
+inline constexpr const char* enable = R"doc(
+Enables/disables the CPU profiler. While enabled, timed zones inside the module (poll_events, run, update_window etc.)
+are recorded per-thread. Disabled zones cost a single branch.
+GPU times of shader runs are included when gl.enable_gpu_timing() is also on.
+
+Parameters
+----------
+enabled : bool, optional
+	Whether zones should be recorded.
+)doc";
+
+
+//Write the recorded zones out.
+inline constexpr const char* dump = R"doc(
+Writes the recorded zones as Chrome trace JSON. Open in chrome://tracing or Perfetto.
+CPU zones are listed under the "CPU" process (one row per thread), shader run times under "GPU".
+
+Parameters
+----------
+file_path : str
+	The filepath to save to.
+
+Returns
+-------
+int
+	Number of events written.
+
+Raises
+------
+RuntimeError
+	If the file could not be opened.
+)doc";
+
+
+//Drop everything recorded.
+inline constexpr const char* clear = R"doc(
+Discards all recorded profiler events.
+)doc";
+
+}
+
+
+
+//Matrix functions
+namespace matrix {
+
+//Gets/creates a matrix of given type.
+inline constexpr const char* get = R"doc(
+Creates a perspective projection matrix from the selected camera index.
+Perspective matrices cause objects to get smaller with distance.
+
+Parameters
+----------
+type : MatrixType
+	Type of matrix to create: [MAT_IDENTITY, MAT_PERSPECTIVE, MAT_ORTHOGRAPHIC, MAT_VIEW, MAT_MODEL].
+camera : int, optional
+	Index of the camera to create the matrix from. Only required for [MAT_PERSPECTIVE, MAT_VIEW].
+position : vector[float, float, float], optional
+	Translation of the matrix. Only required for [MAT_MODEL].
+rotation : vector[float, float, float], optional
+	Rotation of the matrix around its origin. Only required for [MAT_MODEL].
+scale : vector[float, float, float], optional
+	Scale of the matrix relative to its origin. Only required for [MAT_MODEL].
+
+Raises
+------
+RuntimeError
+	For unknown type.
+
+Returns
+-------
+tuple[tuple[float]]
+	A 4x4 2D matrix of tuples representing a matrix. Can be converted to a py-glm mat4 directly.
+)doc";
+
+
+//Many model matrices at once.
+inline constexpr const char* getModelMatrices = R"doc(
+Creates a model matrix for every object in one call, the same as gl.get_matrix(gl.MODEL, ...) for each.
+Uses SSE2/AVX2 where the CPU has them, and several threads for large batches.
+
+Parameters
+----------
+positions : numpy.ndarray
+	(N, 3) translations.
+rotations : numpy.ndarray
+	(N, 3) rotations in radians.
+scales : numpy.ndarray
+	(N, 3) scales.
+
+Raises
+------
+RuntimeError
+	If an array isn't (N, 3), or their lengths differ.
+
+Returns
+-------
+numpy.ndarray
+	(N, 4, 4) float32, each matrix laid out like get_matrix's (glm.mat4(out[i]) works).
+)doc";
+
+}
+
+
+
+//Camera functions
+namespace camera {
+
+//Assign new camera.
+inline constexpr const char* newCamera = R"doc(
+Creates a new camera, returning the ID of this new camera.
+
+Parameters
+----------
+position : vector[float, float, float], optional
+	3D Position to start the camera at.
+angle : vector[float, float, float], optional
+	Yaw/Pitch/Roll to start the camera at.
+up : vector[float, float, float], optional
+	Up-direction of the camera. By default, +Z upwards.
+fov_deg : float
+	Field of view, in degrees. Automatically converted to radians.
+fov_rad : float
+	Field of View, in radians. Preferred over fov_deg if both are present.
+near_z : float
+	The distance from the camera (World units) the closest objects rendered are allowed to be.
+far_z : float
+	The distance from the camera (World units) the furthest objects rendered are allowed to be.
+
+Raises
+------
+RuntimeError
+	If there are already too many cameras created, or if the up-direction is invalid.
+
+Returns
+-------
+int
+	Index of the new camera. Used when modifying its data later, or when using it to create matrices.
+)doc";
+
+
+//Keeps the doc the same for "forward", "right" and "up" using std::format.
+inline constexpr const char* getDir = R"doc(
+Returns the current ?-direction of a camera from its ID.
+
+Parameters
+----------
+camera : int
+	The ID of the camera to access.
+direction : CameraDirection
+	The direction to read from this camera. Uses the CameraDirection enum.
+
+
+Returns
+-------
+vector[float, float float]
+	The camera's ?-direction.
+)doc";
+
+
+inline constexpr const char* newPos = R"doc(
+Sets a new camera position (X/Y/Z | Up-direction depends on camera UP → Can be got via `gl.camera_up(camera=ID))`.) for a camera by its ID.
+
+Parameters
+----------
+camera : int
+	The ID of the camera to edit.
+position : vector[float, float, float], optional
+	3D Position to start the camera at.
 )doc";
 
 
@@ -615,6 +1676,57 @@ camera : int
 	The ID of the camera to delete.
 )doc";
 
+
+//Frustum culling
+//Get every camera matrix
+inline constexpr const char* getMatrices = R"doc(
+Returns all of the camera's matrices at once, along with its basis vectors.
+These are cached by the camera, and only rebuilt when its position, angle, FOV, clip planes or the window's aspect ratio change.
+
+Parameters
+----------
+camera : int
+	The ID of the camera.
+
+Raises
+------
+RuntimeError
+	If the camera ID is invalid.
+
+Returns
+-------
+dict
+	"view", "projection", "view_projection" (projection * view), "inverse_view", "inverse_projection" and
+	"inverse_view_projection" as glm.mat4, plus "position", "forward", "right" and "up" as glm.vec3.
+)doc";
+
+
+//Frustum culling
+inline constexpr const char* cull = R"doc(
+Tests bounding volumes against the camera's view frustum, and returns which are (at least partly) visible.
+Conservative: a volume near a frustum corner may be kept even if just outside, but a visible one is never dropped.
+
+Parameters
+----------
+camera : int
+	The ID of the camera to test against.
+bounds : numpy.ndarray
+	(N, 4) spheres [x, y, z, radius], or (N, 6) axis-aligned boxes [min x, min y, min z, max x, max y, max z].
+mask : bool, optional
+	Return a bool mask instead of the visible indices.
+
+Raises
+------
+RuntimeError
+	If the camera ID is invalid, or bounds isn't (N, 4) or (N, 6).
+
+Returns
+-------
+numpy.ndarray
+	(N,) bool mask if mask, else the indices of visible volumes as uint32 in ascending order,
+	ready to index per-object arrays (positions[indices]) or upload as a per-instance buffer.
+)doc";
+
 }
 
 
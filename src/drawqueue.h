@@ -0,0 +1,206 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+#include "global.h"
+#include "utils.h"
+
+#include <bit>
+
+
+
+//Sorted draw queues.
+//Python queues draws in any order, each with a 64 bit sort key built from its state. gl.flush_draw_queue() radix
+//sorts the keys, so draws sharing a target, program, textures & mesh end up together, then replays them changing
+//only the state that differs. Opaque draws run front to back within their state (early-z), transparent ones after
+//every opaque draw of their target, back to front.
+namespace drawqueue {
+
+
+//Key fields, most significant first. Equal keys keep the order they were queued in (the sort is stable).
+//	Opaque:      [63] 0, [62-58] target+1, [57-53] shader, [52-37] texture set, [36-28] mesh+1, [23-0] depth
+//	Transparent: [63] 1, [62-58] target+1, [57-34] far-to-near depth, [33-29] shader, [28-13] texture set, [12-4] mesh+1
+constexpr unsigned TARGET_BITS = 5u;
+constexpr unsigned SHADER_BITS = 5u;
+constexpr unsigned TEXTURES_BITS = 16u; //Texture set indices past this share key bits, they're still told apart when replayed.
+constexpr unsigned MESH_BITS = 9u;
+constexpr unsigned DEPTH_BITS = 24u;
+
+static_assert(constants::misc::MAX_FRAMEBUFFERS + 1u <= (1u << TARGET_BITS));
+static_assert(constants::misc::MAX_SHADERS <= (1u << SHADER_BITS));
+static_assert(constants::misc::MAX_MESHES + 1u <= (1u << MESH_BITS));
+
+
+inline uint64_t field(uint64_t value, unsigned bits, unsigned shift) {return (value & ((uint64_t(1) << bits) - 1u)) << shift;}
+
+
+//Positive floats order the same as their bits, so the top 24 keep every depth's relative precision. Negative & NaN are 0.
+inline uint64_t depthBits(float depth) {
+	if (!(depth > 0.0f)) {return 0u;}
+	return std::bit_cast<uint32_t>(depth) >> (31u - DEPTH_BITS);
+}
+
+
+inline uint64_t keyOf(bool transparent, int targetID, int shaderID, uint32_t textureSet, int meshID, float depth) {
+	uint64_t key = field(uint64_t(transparent), 1u, 63u) | field(uint64_t(targetID + 1), TARGET_BITS, 58u);
+	if (!transparent) {
+		return key | field(uint64_t(shaderID), SHADER_BITS, 53u) | field(textureSet, TEXTURES_BITS, 37u)
+			| field(uint64_t(meshID + 1), MESH_BITS, 28u) | field(depthBits(depth), DEPTH_BITS, 0u);
+	}
+	uint64_t farToNear = ~depthBits(depth);
+	return key | field(farToNear, DEPTH_BITS, 34u) | field(uint64_t(shaderID), SHADER_BITS, 29u)
+		| field(textureSet, TEXTURES_BITS, 13u) | field(uint64_t(meshID + 1), MESH_BITS, 4u);
+}
+
+
+
+//LSD radix sort of draw indices by key, a byte per pass. Passes where every key shares the byte are skipped.
+inline std::vector<uint32_t> sortByKey(const std::vector<uint64_t>& keys) {
+	size_t count = keys.size();
+	std::vector<uint32_t> order(count), scratch(count);
+	for (size_t i=0; i<count; i++) {order[i] = static_cast<uint32_t>(i);}
+
+	for (unsigned shift=0; shift<64u; shift+=8u) {
+		std::array<size_t, 256> offsets = {};
+		for (uint64_t key : keys) {offsets[(key >> shift) & 0xFFu]++;}
+		if (offsets[(keys.empty()) ? 0u : ((keys[0] >> shift) & 0xFFu)] == count) {continue; /* Already in order on this byte */}
+
+		size_t sum = 0u;
+		for (size_t& offset : offsets) {size_t bucket = offset; offset = sum; sum += bucket;}
+		for (uint32_t i : order) {scratch[offsets[(keys[i] >> shift) & 0xFFu]++] = i;}
+		order.swap(scratch);
+	}
+	return order;
+}
+
+
+
+struct Draw {
+	int shaderID;
+	int meshID;              //-1 draws the shader's own vertices (gl.add_vao)
+	int targetID;            //-1 is the screen
+	uint32_t textureSet;     //Index into Queue::textureSets, 0 is none
+	std::vector<std::pair<GLint, types::UniformValue>> uniforms; //Locations resolved when queued
+
+	//Distinct VAOs: a shader's own vertices are its own, whatever meshID says.
+	int vertexArray() const {return (meshID >= 0) ? meshID : -1 - shaderID;}
+};
+
+
+//State changes made over the draws, in whatever order they ran.
+struct Switches {
+	size_t targets = 0u;
+	size_t programs = 0u;
+	size_t textures = 0u;
+	size_t meshes = 0u;
+
+	size_t total() const {return targets + programs + textures + meshes;}
+};
+
+struct Stats {
+	size_t draws = 0u;
+	Switches made;
+	Switches unsorted; //What queue order would have made
+	size_t avoided() const {return unsorted.total() - std::min(unsorted.total(), made.total());}
+};
+
+
+//Tracks what's bound while walking draws. A new target re-applies everything, a new program its textures & vertices.
+//Per-draw textures & uniforms are the draw's own: the next draw of the same program puts back the shader's where they differ.
+struct Walker {
+	const Draw* last = nullptr;
+
+	//Whether previous set a uniform that next doesn't overwrite.
+	static bool uniformsLeftOver(const Draw& previous, const Draw& next) {
+		for (const auto& [loc, value] : previous.uniforms) {
+			auto sets = [loc](const auto& u) {return u.first == loc;};
+			if (std::none_of(next.uniforms.begin(), next.uniforms.end(), sets)) {return true;}
+		}
+		return false;
+	}
+
+	//Which state draw needs changed, counted into switches.
+	struct Change {bool target, program, textures, mesh, restoreTextures, restoreUniforms;};
+	Change step(const Draw& draw, Switches& switches) {
+		Change c = {true, true, true, true, false, false};
+		if (last && (last->targetID == draw.targetID)) {
+			c.target = false;
+			c.program = (last->shaderID != draw.shaderID);
+			c.textures = c.program || (last->textureSet != draw.textureSet);
+			c.mesh = c.program || (last->vertexArray() != draw.vertexArray());
+			c.restoreTextures = !c.program && c.textures && (last->textureSet != 0u);
+			c.restoreUniforms = !c.program && uniformsLeftOver(*last, draw);
+		}
+		last = &draw;
+		switches.targets += c.target;
+		switches.programs += c.program;
+		switches.textures += c.textures && ((draw.textureSet != 0u) || c.restoreTextures);
+		switches.meshes += c.mesh;
+		return c;
+	}
+};
+
+
+
+class Queue {
+private:
+	bool _valid = false;
+	std::map<std::vector<std::pair<GLuint, int>>, uint32_t> _setIndex;
+
+public:
+	std::vector<Draw> draws;
+	std::vector<uint64_t> keys;
+	std::vector<std::vector<std::pair<GLuint, int>>> textureSets; //(binding, texture ID), sorted by binding
+	std::string name = "";
+
+	void create(const std::string& n) {
+		name = n;
+		clear();
+		_valid = true;
+	}
+
+	bool isValid() const {return _valid;}
+
+
+	//Same set of textures, same index, so draws sharing textures share key bits.
+	uint32_t internTextures(std::vector<std::pair<GLuint, int>> set) {
+		if (set.empty()) {return 0u;}
+		std::sort(set.begin(), set.end());
+		auto [it, added] = _setIndex.try_emplace(set, static_cast<uint32_t>(textureSets.size()));
+		if (added) {textureSets.push_back(std::move(set));}
+		return it->second;
+	}
+
+	void push(Draw&& draw, bool transparent, float depth) {
+		keys.push_back(keyOf(transparent, draw.targetID, draw.shaderID, draw.textureSet, draw.meshID, depth));
+		draws.push_back(std::move(draw));
+	}
+
+	void clear() {
+		draws.clear();
+		keys.clear();
+		_setIndex.clear();
+		textureSets.assign(1u, {}); //Set 0, no textures.
+	}
+
+	void destroy() {
+		draws = {};
+		keys = {};
+		_setIndex = {};
+		textureSets = {};
+		name = "";
+		_valid = false;
+	}
+};
+
+
+inline size_t numberOfQueues = 0u;
+inline std::array<Queue, constants::misc::MAX_DRAW_QUEUES> queues;
+
+
+inline void reset() {
+	for (Queue& q : queues) {q.destroy();}
+	numberOfQueues = 0u;
+}
+
+
+}
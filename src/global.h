@@ -2,6 +2,11 @@
 #include "includes.h"
 #include "constants.h"
 #include "utils.h"
+#include "log.h"
+#include "state.h"
+#include "vertexpack.h"
+
+#include <chrono>
 
 
 
@@ -75,20 +80,34 @@ struct UniformValue {
 };
 
 
+//Set one uniform of the program in use.
+inline void applyUniform(GLint loc, const UniformValue& u) {
+	switch (u.type) {
+		case UniformType::UV_FLOAT: {float      data = std::get<float>(u.data);      glUniform1f(loc, data);  break;}
+		case UniformType::UV_INTEG: {int        data = std::get<int>(u.data);        glUniform1i(loc, data);  break;}
+		case UniformType::UV_FVEC2: {glm::vec2  data = std::get<glm::vec2>(u.data);  glUniform2f(loc, data.x, data.y); break;}
+		case UniformType::UV_IVEC2: {glm::ivec2 data = std::get<glm::ivec2>(u.data); glUniform2i(loc, data.x, data.y); break;}
+		case UniformType::UV_FVEC3: {glm::vec3  data = std::get<glm::vec3>(u.data);  glUniform3f(loc, data.x, data.y, data.z); break;}
+		case UniformType::UV_IVEC3: {glm::ivec3 data = std::get<glm::ivec3>(u.data); glUniform3i(loc, data.x, data.y, data.z); break;}
+		case UniformType::UV_FVEC4: {glm::vec4  data = std::get<glm::vec4>(u.data);  glUniform4f(loc, data.x, data.y, data.z, data.w); break;}
+		case UniformType::UV_IVEC4: {glm::ivec4 data = std::get<glm::ivec4>(u.data); glUniform4i(loc, data.x, data.y, data.z, data.w); break;}
+		case UniformType::UV_MAT33: {glm::mat3  data = std::get<glm::mat3>(u.data);  glUniformMatrix3fv(loc, 1, GL_FALSE, glm::value_ptr(data)); break;}
+		case UniformType::UV_MAT44: {glm::mat4  data = std::get<glm::mat4>(u.data);  glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(data)); break;}
+		default: {break;}
+	}
+}
+
+
 
 //Contains data related to calling a shader.
 //ST_COMPUTE     → localSize
-//ST_WORLDSPACE  → VAO & index count
+//ST_WORLDSPACE  → N/A, draws its own Mesh or the ones it's given
 //ST_SCREENSPACE → N/A
 struct ShaderCall {
 	glm::uvec3 localSize = glm::uvec3(0u, 0u, 0u);
-	GLuint VAO = 0u;
-	unsigned int numberOfIndices = 0u;
-	bool hasVAO = false;
 
-	ShaderCall() : localSize(0u, 0u, 0u), VAO(0u), numberOfIndices(0u), hasVAO(false) {}
-	ShaderCall(glm::uvec3& ls) : localSize(ls), VAO(0u), numberOfIndices(0u), hasVAO(false) {}
-	ShaderCall(GLuint vao, unsigned int nv)	: localSize(0u, 0u, 0u), VAO(vao), numberOfIndices(nv), hasVAO(true) {}
+	ShaderCall() : localSize(0u, 0u, 0u) {}
+	ShaderCall(glm::uvec3& ls) : localSize(ls) {}
 };
 
 
@@ -170,8 +189,7 @@ public:
 		if (!status) {
 			char buffer[constants::misc::GL_ERROR_LENGTH];
 			glGetShaderInfoLog(GLindex, constants::misc::GL_ERROR_LENGTH, nullptr, buffer);
-			utils::cout(std::format("\nShader [{}] compile error:", name));
-			utils::cerr(buffer);
+			utils::cerr(std::format("Shader [{}] compile error:\n{}", name, buffer));
 			return false;
 		}
 		if (GLEW_KHR_debug || GLEW_VERSION_4_3) {
@@ -201,6 +219,11 @@ public:
 	std::pair<GLint, GLint> wrap;
 	GLint format = 0;
 
+	//Hazard tracking, see barriers.h. Serials of the last unsynchronised accesses.
+	uint64_t lastImageWrite = 0u;
+	uint64_t lastImageRead = 0u;
+	int lastWriter = -1; //Shader ID that last wrote it.
+
 
 	Texture() = default;
 	Texture(const std::string n, glm::ivec2 res)
@@ -224,8 +247,11 @@ public:
 		filePath = ""; name = "";
 		minMagFilters = {}; wrap = {};
 		format = 0;
+		lastImageWrite = 0u; lastImageRead = 0u;
+		lastWriter = -1;
 
 		//Free texture from OpenGL.
+		if (GLindex) {glstate::forgetTexture(GLindex);}
 		glDeleteTextures(1, &GLindex);
 		GLindex = 0;
 	}
@@ -233,18 +259,365 @@ public:
 };
 
 
+//Two textures of the same size/format that swap roles. Front is read from, back is written to.
+//Swapping only flips which texture each side resolves to, so every shader using the pair sees it.
+class TexturePair {
+private:
+	bool _valid = false;
+	bool _swapped = false;
+	std::array<Texture*, 2> _textures = {nullptr, nullptr};
+
+public:
+	std::string name = "";
+
+
+	void assign(Texture& front, Texture& back, const std::string& n) {
+		_textures = {&front, &back};
+		_swapped = false;
+		name = n;
+		_valid = true;
+	}
+
+	bool isValid() const {return _valid;}
+
+	//Which texture this side currently points to. Once deleted, an invalid texture, so shaders still bound to it skip it.
+	inline Texture& get(PairSide side) const {
+		if (!_valid) {return deleted();}
+		return *(_textures[static_cast<size_t>(side) ^ static_cast<size_t>(_swapped)]);
+	}
+
+	static Texture& deleted() {static Texture none; return none;}
+
+	inline void swap() {_swapped = !_swapped;}
+
+	//Deletion. Does not free the textures themselves.
+	void destroy() {
+		_valid = false;
+		_swapped = false;
+		_textures = {nullptr, nullptr};
+		name = "";
+	}
+	~TexturePair() {destroy();}
+};
+
+
 //Contains the values required to bind a texture in a shader.
+//Points at either a single texture, or one side of a pair (resolved when applied).
 struct BoundTexture {
-	GLuint GLindex = 0u;
-	std::string name = "";
+	Texture* texture = nullptr;
+	TexturePair* pair = nullptr;
+	PairSide side = PS_FRONT;
+	ImageAccess access = IA_READ_WRITE; //Only used for images.
 	bool isValid = false;
-	bool isSampler2D = false;
-	GLint format = 0;
 
 	BoundTexture() : isValid(false) {}
-	BoundTexture(Texture& texture)
-		: GLindex(texture.GLindex), name(texture.name), isValid(true),
-		  isSampler2D(texture.sampler2D), format(texture.format) {}
+	BoundTexture(Texture& tex, ImageAccess acc)
+		: texture(&tex), pair(nullptr), side(PS_FRONT), access(acc), isValid(true) {}
+	BoundTexture(TexturePair& texPair, PairSide s, ImageAccess acc)
+		: texture(nullptr), pair(&texPair), side(s), access(acc), isValid(true) {}
+
+	inline Texture& resolve() const {return (pair) ? pair->get(side) : *texture;}
+
+	inline bool reads() const {return access != IA_WRITE;}
+	inline bool writes() const {return access != IA_READ;}
+};
+
+
+
+//Finds the readonly/writeonly qualifiers of each image binding in a shader's source.
+static void findImageAccess(const std::string& source, std::unordered_map<GLuint, ImageAccess>& out) {
+	std::regex imageRegex = std::regex(
+		R"(layout\s*\(([^)]*)\)\s*((?:\w+\s+)*?)uniform\s+((?:\w+\s+)*?)\w*image\w+\s+\w+)"
+	);
+	std::regex bindingRegex = std::regex(R"(binding\s*=\s*(\d+))");
+
+	std::sregex_iterator it(source.begin(), source.end(), imageRegex);
+	std::sregex_iterator end;
+	for (; it!=end; it++) {
+		const std::smatch& match = *it;
+		std::string layout = match[1].str();
+		std::string qualifiers = match[2].str() + " " + match[3].str();
+
+		std::smatch bindingMatch;
+		if (!std::regex_search(layout, bindingMatch, bindingRegex)) {continue; /* No explicit binding, can't be added by unit. */}
+		GLuint binding = static_cast<GLuint>(std::stoul(bindingMatch[1].str()));
+
+		bool readOnly = qualifiers.find("readonly") != std::string::npos;
+		bool writeOnly = qualifiers.find("writeonly") != std::string::npos;
+		out[binding] = (readOnly) ? IA_READ : ((writeOnly) ? IA_WRITE : IA_READ_WRITE);
+	}
+}
+
+
+//Render target made of existing textures, so they stay usable as samplers/images by other shaders.
+//Colour attachment N receives the fragment shader's `layout(location=N) out`.
+class Framebuffer {
+private:
+	bool _valid = false;
+
+public:
+	GLuint GLindex = 0u;
+	GLuint depthRBO = 0u; //Optional depth buffer, not readable as a texture.
+	std::vector<Texture*> colours;
+	glm::ivec2 resolution = {0, 0};
+	std::string name = "";
+
+
+	bool create(std::vector<Texture*>& textures, bool depth, const std::string& n) {
+		colours = textures;
+		resolution = textures.front()->resolution;
+		name = n;
+
+		glCreateFramebuffers(1, &GLindex);
+		std::vector<GLenum> drawBuffers;
+		for (size_t i=0; i<colours.size(); i++) {
+			GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+			glNamedFramebufferTexture(GLindex, attachment, colours[i]->GLindex, 0);
+			drawBuffers.push_back(attachment);
+		}
+		glNamedFramebufferDrawBuffers(GLindex, static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+
+		if (depth) {
+			glCreateRenderbuffers(1, &depthRBO);
+			glNamedRenderbufferStorage(depthRBO, GL_DEPTH_COMPONENT24, resolution.x, resolution.y);
+			glNamedFramebufferRenderbuffer(GLindex, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+		}
+
+		GLenum status = glCheckNamedFramebufferStatus(GLindex, GL_FRAMEBUFFER);
+		if (status != GL_FRAMEBUFFER_COMPLETE) {
+			std::string error = std::format("Framebuffer \"{}\" is incomplete [0x{:X}]", name, status);
+			destroy(); //Free what was created, the slot is reused by the next create.
+			utils::cerr(error);
+			return false;
+		}
+		if (GLEW_KHR_debug || GLEW_VERSION_4_3) {glObjectLabel(GL_FRAMEBUFFER, GLindex, -1, name.c_str()); /* Label it for debugging. */}
+
+		_valid = true;
+		return true;
+	}
+
+	bool isValid() const {return _valid;}
+
+	void bind() const {
+		glstate::bindFramebuffer(GLindex);
+		glstate::setViewport(resolution);
+	}
+
+	void clear(glm::vec4 colour, float depth) const {
+		for (size_t i=0; i<colours.size(); i++) {
+			glClearNamedFramebufferfv(GLindex, GL_COLOR, static_cast<GLint>(i), glm::value_ptr(colour));
+		}
+		if (depthRBO) {glClearNamedFramebufferfv(GLindex, GL_DEPTH, 0, &depth);}
+	}
+
+	//Deletion. Does not free the textures themselves.
+	void destroy() {
+		if (GLindex) {glstate::forgetFramebuffer(GLindex); glDeleteFramebuffers(1, &GLindex);}
+		if (depthRBO) {glDeleteRenderbuffers(1, &depthRBO);}
+		GLindex = 0u; depthRBO = 0u;
+		colours = {};
+		resolution = {0, 0};
+		name = "";
+		_valid = false;
+	}
+	~Framebuffer() {destroy();}
+};
+
+
+
+//Reserved uniforms a program declared, found at link time. Filled natively on every run, -1 = not declared.
+//	float u_time;             Seconds since gl.init().
+//	int/uint u_frame;         gl.update_window() calls since gl.init().
+//	vec2/ivec2 u_resolution;  Of whatever is being rendered into.
+//	mat4 u_viewProj[N];       projection * view of camera IDs [0 - N).
+struct BuiltinUniforms {
+	GLint time = -1;
+	GLint frame = -1;
+	GLenum frameType = GL_INT;
+	GLint resolution = -1;
+	GLenum resolutionType = GL_FLOAT_VEC2;
+	GLint viewProj = -1;
+	GLsizei viewProjCount = 0;
+
+	bool any() const {return (time != -1) || (frame != -1) || (resolution != -1) || (viewProj != -1);}
+
+
+	void find(GLuint program) {
+		*this = BuiltinUniforms();
+		GLint count = 0;
+		glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+
+		char buffer[64];
+		for (GLint i=0; i<count; i++) {
+			GLsizei length = 0; GLint size = 0; GLenum type = 0u;
+			glGetActiveUniform(program, static_cast<GLuint>(i), sizeof(buffer), &length, &size, &type, buffer);
+			if ((length < 2) || (buffer[0] != 'u') || (buffer[1] != '_')) {continue; /* Not reserved */}
+			std::string_view uniform(buffer, static_cast<size_t>(length));
+
+			if ((uniform == "u_time") && (type == GL_FLOAT)) {
+				time = glGetUniformLocation(program, buffer);
+			}
+			else if ((uniform == "u_frame") && ((type == GL_INT) || (type == GL_UNSIGNED_INT))) {
+				frame = glGetUniformLocation(program, buffer);
+				frameType = type;
+			}
+			else if ((uniform == "u_resolution") && ((type == GL_FLOAT_VEC2) || (type == GL_INT_VEC2))) {
+				resolution = glGetUniformLocation(program, buffer);
+				resolutionType = type;
+			}
+			else if (((uniform == "u_viewProj") || (uniform == "u_viewProj[0]")) && (type == GL_FLOAT_MAT4)) {
+				viewProj = glGetUniformLocation(program, buffer); //Arrays report "u_viewProj[0]", the first element.
+				viewProjCount = std::min<GLsizei>(size, static_cast<GLsizei>(constants::misc::MAX_CAMERAS));
+			}
+			else {
+				GL_LOG_DEBUG(std::format("Uniform \"{}\" looks reserved but isn't a built-in of that name and type, leaving it to the user", uniform));
+			}
+		}
+	}
+};
+
+
+
+//Vertices & indices on the GPU: a VAO and the buffers it reads.
+//Each shader has one for gl.add_vao(), and any ST_WORLDSPACE shader can draw the ones made by gl.create_mesh().
+class Mesh {
+private:
+	GLuint _VAO = 0u;
+	std::vector<GLuint> _buffers; //Vertex streams, then the index buffer.
+	unsigned int _numberOfIndices = 0u;
+	GLenum _indexType = GL_UNSIGNED_INT;
+
+
+	//Replace the VAO with one reading each stream from its own vertex buffer binding. Built with DSA, so nothing is bound.
+	void _build(const std::vector<vertexpack::AttributeFormat>& attributes, const std::vector<vertexpack::VertexStream>& streams, const std::vector<GLuint>& indices, size_t vertexCount) {
+		vertexpack::checkIndices(indices, vertexCount);
+		destroy();
+		_numberOfIndices = indices.size();
+		_indexType = vertexpack::indexType(vertexCount);
+
+		glCreateVertexArrays(1, &(_VAO));
+		_buffers.resize(streams.size() + 1u);
+		glCreateBuffers(static_cast<GLsizei>(_buffers.size()), _buffers.data());
+		for (size_t s=0; s<streams.size(); s++) {
+			glNamedBufferData(_buffers[s], streams[s].bytes, streams[s].data, GL_STATIC_DRAW); //Uploaded once
+			glVertexArrayVertexBuffer(_VAO, static_cast<GLuint>(s), _buffers[s], 0, streams[s].stride);
+		}
+
+		GLuint EBO = _buffers.back();
+		if (_indexType == GL_UNSIGNED_SHORT) {
+			std::vector<uint16_t> narrow = vertexpack::narrowIndices(indices);
+			glNamedBufferData(EBO, narrow.size() * sizeof(uint16_t), narrow.data(), GL_STATIC_DRAW);
+		} else {
+			glNamedBufferData(EBO, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+		}
+		glVertexArrayElementBuffer(_VAO, EBO);
+
+		for (const vertexpack::AttributeFormat& attr : attributes) {
+			GL_LOG_DEBUG(std::format(
+				"Adding attribute at location [{}] with size: [{} VALUES, {} BYTES] from stream [{}]",
+				attr.location, attr.size, vertexpack::bytesOf(attr), attr.stream
+			));
+			glEnableVertexArrayAttrib(_VAO, attr.location);
+			if (attr.integer) {glVertexArrayAttribIFormat(_VAO, attr.location, attr.size, attr.type, attr.offset);}
+			else {glVertexArrayAttribFormat(_VAO, attr.location, attr.size, attr.type, attr.normalized, attr.offset);}
+			glVertexArrayAttribBinding(_VAO, attr.location, attr.stream);
+		}
+	}
+
+
+public:
+	std::string name = ""; //For debugging & stats.
+
+
+	//Default creation
+	Mesh() = default;
+
+
+	//Stop shallow copying, delete the methods.
+	Mesh(const Mesh&) = delete;
+	Mesh& operator=(const Mesh&) = delete;
+
+
+	//Move constructor & operator
+	Mesh(Mesh&& other) noexcept {*this = std::move(other);}
+	Mesh& operator=(Mesh&& other) noexcept {
+		if (this != &other) {
+			destroy();
+			_VAO = other._VAO;
+			_buffers = std::move(other._buffers);
+			_numberOfIndices = other._numberOfIndices;
+			_indexType = other._indexType;
+			name = std::move(other.name);
+			other._VAO = 0u;
+			other._buffers.clear();
+			other._numberOfIndices = 0u;
+		}
+		return *this;
+	}
+
+
+	//Deletion
+	void destroy() {
+		if (_VAO) {glstate::forgetVertexArray(_VAO); glDeleteVertexArrays(1, &_VAO);}
+		if (!_buffers.empty()) {glDeleteBuffers(static_cast<GLsizei>(_buffers.size()), _buffers.data());}
+		_VAO = 0u;
+		_buffers.clear();
+		_numberOfIndices = 0u;
+		_indexType = GL_UNSIGNED_INT;
+	}
+	~Mesh() {destroy();}
+
+
+	bool isValid() const {return _VAO != 0u;}
+	unsigned int numberOfIndices() const {return _numberOfIndices;}
+
+
+	void setFormat(VAOFormat format, std::vector<float>& vertices, std::vector<GLuint>& indices, VertexPacking packing) {
+		//Create VAO with given format and values.
+		std::unordered_map<VAOFormat, std::string> formatNameMap = std::unordered_map<VAOFormat, std::string>{
+			{VAO_EMPTY, "VAO_EMPTY"}, 						{VAO_POS_ONLY, "VAO_POS_ONLY"},				 {VAO_POS_NORMAL, "VAO_POS_NORMAL"},
+			{VAO_POS_UV2D, "VAO_POS_UV2D"}, 				{VAO_POS_UV3D, "VAO_POS_UV3D"},
+			{VAO_POS_UV2D_NORMAL, "VAO_POS_UV2D_NORMAL"}, 	{VAO_POS_UV3D_NORMAL, "VAO_POS_UV3D_NORMAL"}
+		};
+		GL_LOG_MINIMAL(std::format(
+			"Creating VAO with format [{}]", formatNameMap[format]
+		));
+		if (format == VAO_EMPTY) {destroy(); return; /* No vertices. */}
+		size_t vertexSizeSingular = constants::display::vertexFormatSizeMap.at(format);
+		if ((vertices.size() % vertexSizeSingular) != 0u) {
+			utils::cerr(std::format("[{}] vertex values is not a multiple of the format's [{}] per vertex", vertices.size(), vertexSizeSingular));
+		}
+		size_t vertexCount = vertices.size() / vertexSizeSingular;
+		vertexpack::Layout layout = vertexpack::layoutOf(format, packing);
+		GL_LOG_DEBUG(std::format(
+			"Vertex layout is [{} BYTES] per vertex ([{} BYTES] as float32), indices are [{} BYTES] each",
+			layout.stride, vertexSizeSingular*sizeof(float), vertexpack::indexBytes(vertexpack::indexType(vertexCount))
+		));
+
+		if (packing == VP_FLOAT) {
+			_build(layout.attributes, {{vertices.data(), vertices.size() * sizeof(float), layout.stride}}, indices, vertexCount);
+		} else {
+			std::vector<uint8_t> packed = vertexpack::packVertices(vertices, vertexSizeSingular, layout);
+			_build(layout.attributes, {{packed.data(), packed.size(), layout.stride}}, indices, vertexCount);
+		}
+	}
+
+
+	//Create VAO from a user-defined layout, reading the given buffers as they are.
+	void setLayout(const std::vector<vertexpack::AttributeFormat>& attributes, const std::vector<vertexpack::VertexStream>& streams, const std::vector<GLuint>& indices) {
+		GL_LOG_MINIMAL(std::format("Creating VAO with a custom layout of [{}] attributes in [{}] streams", attributes.size(), streams.size()));
+		GLint maxAttributes = 0;
+		glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttributes);
+		size_t vertexCount = vertexpack::checkLayout(attributes, streams, static_cast<GLuint>(maxAttributes));
+		_build(attributes, streams, indices, vertexCount);
+	}
+
+
+	//Needs the program in use. Only the VAO binding changes between meshes.
+	void draw() const {
+		glstate::bindVertexArray(_VAO);
+		glDrawElements(GL_TRIANGLES, _numberOfIndices, _indexType, nullptr);
+	}
 };
 
 
@@ -255,11 +628,41 @@ private:
 	GLuint _program = 0u; //OpenGL index
 	bool _linked = false; //Ready to be used or not
 	std::unordered_map<std::string, UniformValue> _uniforms; //Uniforms and their names to bind
-	std::unordered_map<GLuint, BoundTexture> _textures; //GL Indices & data of textures to bind at runtime.
+	std::vector<std::pair<GLuint, BoundTexture>> _textures; //Bindings & data of textures to bind at runtime, sorted by binding.
+	std::unordered_map<GLuint, ImageAccess> _imageAccess; //Image access declared in the shader source, by binding.
+	BuiltinUniforms _builtins; //Reserved uniforms this program declared.
 	ShaderCall _call; //Contains data to be used when doing shader.run();
+	Mesh _mesh; //Vertices from gl.add_vao(), drawn when run() isn't given meshes.
+
+
+	//Every member, leaving other an empty, unlinked program.
+	void _take(ShaderProgram& other) {
+		_program = other._program;
+		_linked = other._linked;
+		_uniforms = std::move(other._uniforms);
+		_textures = std::move(other._textures);
+		_imageAccess = std::move(other._imageAccess);
+		_builtins = other._builtins;
+		_call = other._call;
+		_mesh = std::move(other._mesh);
+		type = other.type;
+		name = std::move(other.name);
+
+		other._program = 0u;
+		other._linked = false;
+		other._uniforms = {};
+		other._textures = {};
+		other._imageAccess = {};
+		other._builtins = BuiltinUniforms();
+		other._call = ShaderCall();
+		other.type = ST_NONE;
+		other.name = "";
+	}
+
 
 public:
 	ShaderType type = ST_NONE; //Type of shader.
+	std::string name = ""; //Source file name(s), for debugging & stats.
 
 
 	//Default creation
@@ -273,23 +676,15 @@ public:
 
 	//Move constructor
 	ShaderProgram(ShaderProgram&& other) noexcept {
-		_program = other._program;
-		_linked = other._linked;
-		type = other.type;
-		_uniforms = std::move(other._uniforms);
-		other._program = 0;
+		_take(other);
 	}
 
 
 	//Move operator
 	ShaderProgram& operator=(ShaderProgram&& other) noexcept {
 		if (this != &other) {
-			if (_program) glDeleteProgram(_program);
-			_program = other._program;
-			_linked = other._linked;
-			type = other.type;
-			_uniforms = std::move(other._uniforms);
-			other._program = 0;
+			if (_program) {glstate::forgetProgram(_program); glDeleteProgram(_program);}
+			_take(other);
 		}
 		return *this;
 	}
@@ -297,14 +692,18 @@ public:
 
 	//Deletion
 	void destroy() {
-		if (_program) {glDeleteProgram(_program);}
+		if (_program) {glstate::forgetProgram(_program); glDeleteProgram(_program);}
+		_mesh.destroy();
 
 		_program = 0u;
 		_linked = false;
 		_uniforms = {};
 		_textures = {};
+		_imageAccess = {};
+		_builtins = BuiltinUniforms();
 		_call = ShaderCall();
 		type = ST_NONE;
+		name = "";
 	}
 	~ShaderProgram() {destroy();}
 
@@ -330,7 +729,7 @@ public:
 			//Find dispatch size def
 			GLint workGroupSize[3];
 			glGetProgramiv(_program, GL_COMPUTE_WORK_GROUP_SIZE, workGroupSize);
-			utils::cout(std::format("Found ST_COMPUTE local size of: [{}, {}, {}]", workGroupSize[0], workGroupSize[1], workGroupSize[2]));
+			GL_LOG_MINIMAL(std::format("Found ST_COMPUTE local size of: [{}, {}, {}]", workGroupSize[0], workGroupSize[1], workGroupSize[2]));
 
 			_call.localSize = glm::uvec3(
 				static_cast<unsigned int>(workGroupSize[0]),
@@ -341,9 +740,12 @@ public:
 
 
 		for (ShaderObject& sh : shaders) {
-			//Delete shader, it has been used.
+			//Find the image access qualifiers, then delete shader, it has been used.
+			findImageAccess(sh.source, _imageAccess);
 			sh.destroy();
 		}
+		_builtins.find(_program);
+		if (_builtins.any()) {GL_LOG_DEBUG("Program declares built-in uniforms, they'll be set on every run");}
 
 		_linked = true;
 		this->type = type;
@@ -351,91 +753,43 @@ public:
 	}
 
 
-	void setVAO(VAOFormat format, std::vector<float>& vertices, std::vector<GLuint>& indices) {
-		//Create VAO with given format and values.
-		std::unordered_map<VAOFormat, std::string> formatNameMap = std::unordered_map<VAOFormat, std::string>{
-			{VAO_EMPTY, "VAO_EMPTY"}, 						{VAO_POS_ONLY, "VAO_POS_ONLY"},				 {VAO_POS_NORMAL, "VAO_POS_NORMAL"},
-			{VAO_POS_UV2D, "VAO_POS_UV2D"}, 				{VAO_POS_UV3D, "VAO_POS_UV3D"},
-			{VAO_POS_UV2D_NORMAL, "VAO_POS_UV2D_NORMAL"}, 	{VAO_POS_UV3D_NORMAL, "VAO_POS_UV3D_NORMAL"}
-		};
-		utils::cout(std::format(
-			"Creating VAO with format [{}]", formatNameMap[format]
-		));
-		if (format == VAO_EMPTY) {
-			_call.numberOfIndices = 0u;
-			_call.VAO = constants::display::emptyVAO;
-			return;
-		}
-		size_t vertexSizeSingular = constants::display::vertexFormatSizeMap.at(format);
-		_call.numberOfIndices = indices.size();
-
-	
-		glGenVertexArrays(1, &(_call.VAO));
-		glBindVertexArray(_call.VAO);
-
-		GLuint VBO, EBO;
-		glGenBuffers(1, &VBO);
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW); //Reserve space
-
-		glGenBuffers(1, &EBO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, _call.numberOfIndices * sizeof(GLuint), indices.data(), GL_DYNAMIC_DRAW); //Reserve space
-
-
-		size_t offset = 0u;
-		unsigned int attribID = 0;
-		//Loop through and set attributes based on the format. For instance, VAO_POS_UV2D_NORMAL = {3, 2, 3}.
-		for (const Attribute& attr : (constants::display::layouts.at(format))) {
-			utils::cout(V_DEBUG, std::format("Adding attribute with size: [{} VALUES, {} BYTES]", attr.size, attr.size*sizeof(float)));
-			glVertexAttribPointer(attribID, attr.size, GL_FLOAT, GL_FALSE, vertexSizeSingular * sizeof(float), (void*)(offset * sizeof(float)));
-			glEnableVertexAttribArray(attribID++);
-			offset += attr.size;
-		}
-
-		glBindVertexArray(0);
-		_call.hasVAO = true;
+	void setVAO(VAOFormat format, std::vector<float>& vertices, std::vector<GLuint>& indices, VertexPacking packing) {_mesh.setFormat(format, vertices, indices, packing);}
+	void setVAOLayout(const std::vector<vertexpack::AttributeFormat>& attributes, const std::vector<vertexpack::VertexStream>& streams, const std::vector<GLuint>& indices) {
+		_mesh.setLayout(attributes, streams, indices);
 	}
 
 
-	inline void use() {if (_linked) {glUseProgram(_program);} else {utils::cerr("Must create shader first, before using it.");}}
+	bool isLinked() const {return _linked;}
+	const BuiltinUniforms& builtins() const {return _builtins;}
+	inline void use() {if (_linked) {glstate::useProgram(_program);} else {utils::cerr("Must create shader first, before using it.");}}
 
 
 	template<typename T>
 	void setUniform(const std::string& name, const T& val) {
-		utils::cout(std::format("Setting uniform value with Name=\"{}\"", name));
+		GL_LOG_MINIMAL(std::format("Setting uniform value with Name=\"{}\"", name));
 		_uniforms[name] = UniformValue(val);
 	}
 
 
+	GLint uniformLocation(const std::string& name) const {return glGetUniformLocation(_program, name.c_str());}
+
+
 	void applyUniforms() {
 		for (const auto& [name, u] : _uniforms) {
 			GLint loc = glGetUniformLocation(_program, name.c_str());
 			if (loc == -1) {continue; /* Invalid location for this shader. */}
-			utils::cout(V_DEBUG, std::format("Applying uniform with Name=\"{}\"", name));
-
-			switch (u.type) {
-				case UniformType::UV_FLOAT: {float      data = std::get<float>(u.data);      glUniform1f(loc, data);  break;}
-				case UniformType::UV_INTEG: {int        data = std::get<int>(u.data);        glUniform1i(loc, data);  break;}
-				case UniformType::UV_FVEC2: {glm::vec2  data = std::get<glm::vec2>(u.data);  glUniform2f(loc, data.x, data.y); break;}
-				case UniformType::UV_IVEC2: {glm::ivec2 data = std::get<glm::ivec2>(u.data); glUniform2i(loc, data.x, data.y); break;}
-				case UniformType::UV_FVEC3: {glm::vec3  data = std::get<glm::vec3>(u.data);  glUniform3f(loc, data.x, data.y, data.z); break;}
-				case UniformType::UV_IVEC3: {glm::ivec3 data = std::get<glm::ivec3>(u.data); glUniform3i(loc, data.x, data.y, data.z); break;}
-				case UniformType::UV_FVEC4: {glm::vec4  data = std::get<glm::vec4>(u.data);  glUniform4f(loc, data.x, data.y, data.z, data.w); break;}
-				case UniformType::UV_IVEC4: {glm::ivec4 data = std::get<glm::ivec4>(u.data); glUniform4i(loc, data.x, data.y, data.z, data.w); break;}
-				case UniformType::UV_MAT33: {glm::mat3  data = std::get<glm::mat3>(u.data);  glUniformMatrix3fv(loc, 1, GL_FALSE, glm::value_ptr(data)); break;}
-				case UniformType::UV_MAT44: {glm::mat4  data = std::get<glm::mat4>(u.data);  glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(data)); break;}
-				default: {break;}
-			}
+			GL_LOG_DEBUG(std::format("Applying uniform with Name=\"{}\"", name));
+			applyUniform(loc, u);
 		}
 	}
 
 
-	bool run(glm::uvec3 dispatchSize, unsigned int shaderID) {
+	//ST_WORLDSPACE draws each of meshes, or its own if none are given.
+	bool run(glm::uvec3 dispatchSize, unsigned int shaderID, std::span<const Mesh* const> meshes) {
 		switch (this->type) {
 			case ST_COMPUTE: {
 				//Dispatch compute
-				utils::cout(std::format(
+				GL_LOG_MINIMAL(std::format(
 					"Running Compute shader ID [{}] with dispatch size [{}, {}, {}]",
 					shaderID, dispatchSize.x,
 					dispatchSize.y,	dispatchSize.z
@@ -447,74 +801,160 @@ public:
 
 			case ST_WORLDSPACE: {
 				//Run worldspace (3D)
-				utils::cout(std::format(
-					"Running Worldspace [3D] shader ID [{}]",	shaderID
+				GL_LOG_MINIMAL(std::format(
+					"Running Worldspace [3D] shader ID [{}] over [{}] meshes",	shaderID, std::max<size_t>(meshes.size(), 1u)
 				));
-				if (!_call.hasVAO) {
+				if (!meshes.empty()) {
+					for (const Mesh* mesh : meshes) {mesh->draw(); /* Program, textures & uniforms are already set. */}
+					break;
+				}
+				if (!_mesh.isValid()) {
 					//No VAO added.
 					utils::cerr(std::format("No vertices were bound to the shader. Use \"gl.add_vao(shaderID, format, values)\" where shaderID=[{}]", shaderID));
 					return false;
 				}
-				glBindVertexArray(_call.VAO);
-				glDrawElements(GL_TRIANGLES, _call.numberOfIndices, GL_UNSIGNED_INT, nullptr);
-				glBindVertexArray(0);
+				_mesh.draw();
 				break;
 			}
 
 			case ST_SCREENSPACE: {
 				//Run screenspace (2D)
-				utils::cout(std::format(
+				GL_LOG_MINIMAL(std::format(
 					"Running Screenspace [2D] shader ID [{}]",	shaderID
 				));
-				glBindVertexArray(constants::display::emptyVAO); //No VAO needed, uses vertices from the vertex-shader.
+				glstate::bindVertexArray(constants::display::emptyVAO); //No VAO needed, uses vertices from the vertex-shader.
 				glDrawArrays(GL_TRIANGLE_STRIP, 0u, 4u);
-				glBindVertexArray(0);
 				break;
 			}
 			default: {return false; /* Unknown type */}
 		}
-		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 		return true;
 	}
 
 
-	bool bindTexture(GLuint binding, Texture& texture) {
+	//Access the shader source declared for this image binding, unless overridden.
+	ImageAccess resolveAccess(GLuint binding, ImageAccess access) const {
+		if (access != IA_AUTO) {return access;}
+		auto it = _imageAccess.find(binding);
+		return (it == _imageAccess.end()) ? IA_READ_WRITE : it->second;
+	}
+
+	//What the shader source says about this binding. [IA_AUTO if not declared]
+	ImageAccess declaredAccess(GLuint binding) const {
+		auto it = _imageAccess.find(binding);
+		return (it == _imageAccess.end()) ? IA_AUTO : it->second;
+	}
+
+	const std::vector<std::pair<GLuint, BoundTexture>>& textures() const {return _textures;}
+
+
+	//Insert or replace, keeping bindings sorted so consecutive units can be bound together.
+	void setBinding(GLuint binding, const BoundTexture& bTex) {
+		auto it = std::lower_bound(
+			_textures.begin(), _textures.end(), binding,
+			[](const std::pair<GLuint, BoundTexture>& entry, GLuint b) {return entry.first < b;}
+		);
+		if ((it != _textures.end()) && (it->first == binding)) {it->second = bTex;}
+		else {_textures.insert(it, {binding, bTex});}
+	}
+
+
+	bool bindTexture(GLuint binding, Texture& texture, ImageAccess access) {
 		if (!texture.isValid()) {
 			utils::cerr("Tried to bind invalid texture");
 			return false;
 		}
 
-		_textures[binding] = BoundTexture(texture); //TBA - implement BoundTexture struct. [NEEDS: isSampelr2D[bool], GLindex[GLuint], format[GLint]]
+		setBinding(binding, BoundTexture(texture, resolveAccess(binding, access)));
+
+		return true;
+	}
+
+
+	bool bindTexturePair(GLuint binding, TexturePair& pair, PairSide side, ImageAccess access) {
+		if (!pair.isValid()) {
+			utils::cerr("Tried to bind invalid texture pair");
+			return false;
+		}
+
+		setBinding(binding, BoundTexture(pair, side, resolveAccess(binding, access)));
 
 		return true;
 	}
 
 
 	void applyTextures() {
+		//Split into samplers & images (still sorted), then let the state cache bind only what changed.
+		thread_local std::vector<glstate::TextureBind> samplers;
+		thread_local std::vector<glstate::ImageBind> images;
+		samplers.clear(); images.clear();
+
 		for (const auto& [binding, bTex] : _textures) {
-			if (bTex.isSampler2D) {
-				utils::cout(V_DEBUG, std::format("Applying texture with Name=\"{}\"", bTex.name));
-				glBindTextureUnit(binding, bTex.GLindex);
+			const Texture& tex = bTex.resolve();
+			if (!tex.isValid()) {continue; /* Deleted since it was bound. */}
+
+			if (tex.sampler2D) {
+				GL_LOG_DEBUG(std::format("Applying texture with Name=\"{}\"", tex.name));
+				samplers.push_back({binding, tex.GLindex});
 			} else {
-				utils::cout(V_DEBUG, std::format("Applying image with Name=\"{}\"", bTex.name));
-				glBindImageTexture(
-					binding, bTex.GLindex,
-					0, GL_FALSE, 0,
-					GL_READ_WRITE, bTex.format
-				);
+				GL_LOG_DEBUG(std::format("Applying image with Name=\"{}\"", tex.name));
+				images.push_back({
+					binding, tex.GLindex,
+					constants::display::imageAccessMap.at(bTex.access), static_cast<GLenum>(tex.format)
+				});
 			}
 		}
+
+		glstate::bindTextureUnits(samplers.data(), samplers.size());
+		glstate::bindImageUnits(images.data(), images.size());
 	}
 };
 
 
 
 class Camera {
+public:
+	//Everything derived from the camera's values, rebuilt only when one of them (or the aspect ratio) changes.
+	struct Matrices {
+		glm::mat4 view = glm::mat4(1.0f);
+		glm::mat4 projection = glm::mat4(1.0f);
+		glm::mat4 viewProjection = glm::mat4(1.0f);
+		glm::mat4 inverseView = glm::mat4(1.0f);
+		glm::mat4 inverseProjection = glm::mat4(1.0f);
+		glm::mat4 inverseViewProjection = glm::mat4(1.0f);
+	};
+
 private:
 	bool _valid = false;
+	bool _viewDirty = true;
+	bool _projectionDirty = true;
+	bool _combinedDirty = true; //viewProjection & its inverse, after either half changes.
+	float _aspect = 0.0f; //Aspect ratio the projection was built for.
+	Matrices _matrices;
+
+	void _refreshView() {
+		float sx = sin(angle.x), cx = cos(angle.x);
+		float sy = sin(angle.y), cy = cos(angle.y);
+		forward = glm::vec3(sx*cy, cx*cy, sy);
+		right = glm::cross(forward, up);
+
+		_matrices.view = glm::lookAt(position, position + forward, up);
+		_matrices.inverseView = glm::inverse(_matrices.view);
+		_viewDirty = false;
+		_combinedDirty = true;
+	}
+
+	void _refreshProjection(float aspect) {
+		float verticalFOV = 2 * atan(tan(FOV * 0.5f) / aspect);
+		_matrices.projection = glm::perspective(verticalFOV, aspect, nearZ, farZ);
+		_matrices.inverseProjection = glm::inverse(_matrices.projection);
+		_aspect = aspect;
+		_projectionDirty = false;
+		_combinedDirty = true;
+	}
 
 public:
+	//Read freely, but change through the setters so the cache knows.
 	glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f);
 	glm::vec3 angle = glm::vec3(0.0f, 0.0f, 0.0f);
 
@@ -530,21 +970,49 @@ public:
 		position = p; angle = a;
 		up = u;	FOV = fov;
 		nearZ = nz;	farZ = fz;
+		_viewDirty = _projectionDirty = _combinedDirty = true;
 		_valid = true;
 	}
 
 	bool isValid() {return _valid;}
 
+	void setPosition(glm::vec3 p) {if (p != position) {position = p; _viewDirty = true;}}
+	void setAngle(glm::vec3 a) {if (a != angle) {angle = a; _viewDirty = true;}}
+	void setFOV(float fov) {if (fov != FOV) {FOV = fov; _projectionDirty = true;}}
+	void setClip(float nz, float fz) {if ((nz != nearZ) || (fz != farZ)) {nearZ = nz; farZ = fz; _projectionDirty = true;}}
+
+
+	//Up to date matrices for a framebuffer of this size.
+	const Matrices& matrices(glm::ivec2 resolution) {
+		float aspect = (resolution.y > 0) ? (float(resolution.x) / float(resolution.y)) : 1.0f;
+		if (_viewDirty) {_refreshView();}
+		if (_projectionDirty || (aspect != _aspect)) {_refreshProjection(aspect);}
+		if (_combinedDirty) {
+			_matrices.viewProjection = _matrices.projection * _matrices.view;
+			_matrices.inverseViewProjection = _matrices.inverseView * _matrices.inverseProjection;
+			_combinedDirty = false;
+		}
+		return _matrices;
+	}
+
+	//forward/right follow the angle; only the view half needs rebuilding.
+	void refreshBasis() {if (_viewDirty) {_refreshView();}}
+
+
 	//Deletion
 	void destroy() {
 		//Set invalid, and reset to defaults.
 		_valid = false;
 		position = glm::vec3(0.0f, 0.0f, 0.0f);
 		angle = glm::vec3(0.0f, 0.0f, 0.0f);
+		forward = glm::vec3(0.0f, 1.0f, 0.0f);
+		right = glm::vec3(1.0f, 0.0f, 0.0f);
 		up = glm::vec3(0.0f, 0.0f, 1.0f);
 		FOV = 0.0f;
 		nearZ = -1.0f;
 		farZ = 1.0f;
+		_viewDirty = _projectionDirty = _combinedDirty = true;
+		_aspect = 0.0f;
 	}
 	~Camera() {destroy();}
 };
@@ -562,13 +1030,27 @@ inline GLFWwindow* window = nullptr;
 inline size_t numberOfShaders;
 inline size_t numberOfTextures;
 inline size_t numberOfCameras;
+inline size_t numberOfTexturePairs;
+inline size_t numberOfFramebuffers;
+inline size_t numberOfMeshes;
 //Respective datasets;
 inline std::array<types::ShaderProgram, constants::misc::MAX_SHADERS> shaders; //All shaders the user has loaded
 inline std::array<types::Texture, constants::misc::MAX_TEXTURES> textures;     //All textures the user may bind / write to
 inline std::array<types::Camera, constants::misc::MAX_CAMERAS> cameras;        //All cameras the user controls
+inline std::array<types::TexturePair, constants::misc::MAX_TEXTURE_PAIRS> texturePairs; //Double-buffered textures
+inline std::array<types::Framebuffer, constants::misc::MAX_FRAMEBUFFERS> framebuffers; //Render targets made of textures
+inline std::array<types::Mesh, constants::misc::MAX_MESHES> meshes;                 //Vertices any worldspace shader can draw
 
 inline bool init = false;
+inline std::thread::id contextThread; //Thread that called gl.init(), the only one allowed to make GL calls.
+inline bool headless = false; //No window/display server, rendering into an offscreen framebuffer.
+inline ContextMode contextMode = CM_DEBUG;
+inline GLuint defaultFramebuffer = 0u; //What "the screen" is. 0 unless headless.
 inline glm::ivec2 windowResolution;
 
+//For the built-in uniforms.
+inline std::chrono::steady_clock::time_point startTime = {}; //gl.init()
+inline uint64_t frameIndex = 0u; //Bumped by gl.update_window()
+
 }
 
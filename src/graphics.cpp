@@ -1,6 +1,15 @@
 #include "includes.h"
 #include "global.h"
 #include "utils.h"
+#include "barriers.h"
+#include "timing.h"
+#include "profiler.h"
+#include "commands.h"
+#include "drawqueue.h"
+#include "pacing.h"
+#include "input.h"
+#include "debug.h"
+#include "simd.h"
 
 
 //////// PY MODULE ////////
@@ -27,86 +36,27 @@ namespace py = pybind11;
 
 namespace graphics {
 
-void APIENTRY openGLErrorCallback(
-		GLenum source,
-		GLenum type, GLuint id,
-		GLenum severity,
-		GLsizei length, const GLchar* message,
-		const void* userParam
-	) {
-	/*
-	Nicely formatted callback from;
-	[https://learnopengl.com/In-Practice/Debugging]
-	*/
-	if(id == 131169 || id == 131185 || id == 131218 || id == 131204) {return;}
-
-	std::cout << "---------------" << std::endl << "Debug message (" << id << ") | " << message << std::endl;
-
-	switch (source)
-	{
-		case GL_DEBUG_SOURCE_API:             {std::cout << "Source: API"; break;}
-		case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   {std::cout << "Source: Window System"; break;}
-		case GL_DEBUG_SOURCE_SHADER_COMPILER: {std::cout << "Source: Shader Compiler"; break;}
-		case GL_DEBUG_SOURCE_THIRD_PARTY:     {std::cout << "Source: Third Party"; break;}
-		case GL_DEBUG_SOURCE_APPLICATION:     {std::cout << "Source: Application"; break;}
-		case GL_DEBUG_SOURCE_OTHER:           {std::cout << "Source: Other"; break;}
-	} std::cout << std::endl;
-
-	switch (type)
-	{
-		case GL_DEBUG_TYPE_ERROR:               {std::cout << "Type: Error"; break;}
-		case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: {std::cout << "Type: Deprecated Behaviour"; break;}
-		case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  {std::cout << "Type: Undefined Behaviour"; break;} 
-		case GL_DEBUG_TYPE_PORTABILITY:         {std::cout << "Type: Portability"; break;}
-		case GL_DEBUG_TYPE_PERFORMANCE:         {std::cout << "Type: Performance"; break;}
-		case GL_DEBUG_TYPE_MARKER:              {std::cout << "Type: Marker"; break;}
-		case GL_DEBUG_TYPE_PUSH_GROUP:          {std::cout << "Type: Push Group"; break;}
-		case GL_DEBUG_TYPE_POP_GROUP:           {std::cout << "Type: Pop Group"; break;}
-		case GL_DEBUG_TYPE_OTHER:               {std::cout << "Type: Other"; break;}
-	} std::cout << std::endl;
-	
-	switch (severity)
-	{
-		case GL_DEBUG_SEVERITY_HIGH:         {std::cout << "Severity: high"; break;}
-		case GL_DEBUG_SEVERITY_MEDIUM:       {std::cout << "Severity: medium"; break;}
-		case GL_DEBUG_SEVERITY_LOW:          {std::cout << "Severity: low"; break;}
-		case GL_DEBUG_SEVERITY_NOTIFICATION: {std::cout << "Severity: notification"; break;}
-	} std::cout << std::endl;
-	std::cout << std::endl;
-
-	if (constants::misc::PAUSE_ON_OPENGL_ERROR) {
-		utils::pause();
-	}
-}
-
-
 void prepareOpenGL() {
 	//Set up any requirements for the context.
-	utils::cout("Configuring OpenGL-wide options");
+	GL_LOG_MINIMAL("Configuring OpenGL-wide options");
+
 
+	//New context, nothing the cache knows is true any more.
+	glstate::reset();
 
 	//Debug settings
-	glEnable(GL_DEBUG_OUTPUT);
-	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-	glDebugMessageCallback(openGLErrorCallback, nullptr);
-	glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+	if (shared::contextMode == CM_DEBUG) {
+		if (!gldebug::enable()) {GL_LOG_MINIMAL("Debug output needs OpenGL 4.3 or KHR_debug, no debug messages will be collected.");}
+	}
 
-	glViewport(0, 0, shared::windowResolution.x, shared::windowResolution.y);
+	glstate::bindFramebuffer(shared::defaultFramebuffer);
+	glstate::setViewport(shared::windowResolution);
 
 	//Create the empty VAO used in screenspace shaders
 	glGenVertexArrays(1, &constants::display::emptyVAO); //Yes technically not constant, but it will _NEVER_ change after now.
 }
 
 
-void glfwKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-	auto it = currentKeyMap.find(key);
-	if (it == currentKeyMap.end()) {return;}
-
-	if (action == GLFW_PRESS) {it->second = true;} 
-	else if (action == GLFW_RELEASE) {it->second = false;}
-}
-
-
 
 bool castMat3(py::object value, glm::mat3 &out) {
 	try { out = value.cast<glm::mat3>(); return true; } catch(...) {}
@@ -120,6 +70,26 @@ bool castMat4(py::object value, glm::mat4 &out) {
 	return false;
 }
 
+//Any supported Python value → uniform value.
+bool castUniform(py::object value, types::UniformValue &out) {
+	//1D values
+	if (py::isinstance<py::int_>(value)) {out = types::UniformValue(value.cast<int>()); return true;}
+	if (py::isinstance<py::float_>(value)) {out = types::UniformValue(value.cast<float>()); return true;}
+	if (py::isinstance<py::bool_>(value)) {out = types::UniformValue(value.cast<bool>()); return true;}
+
+	//Vectors
+	try {out = types::UniformValue(value.cast<glm::vec2>()); return true;} catch(...) {}
+	try {out = types::UniformValue(value.cast<glm::vec3>()); return true;} catch(...) {}
+	try {out = types::UniformValue(value.cast<glm::vec4>()); return true;} catch(...) {}
+
+	//Matrices
+	glm::mat3 mat3; glm::mat4 mat4;
+	if (castMat3(value, mat3)) {out = types::UniformValue(mat3); return true;}
+	if (castMat4(value, mat4)) {out = types::UniformValue(mat4); return true;}
+
+	return false;
+}
+
 
 
 
@@ -128,7 +98,7 @@ namespace compiler {
 //Different types of shaders.
 int computeShader(std::string filePath) {
 	//For compute shaders.
-	utils::cout(std::format("Compiling Compute shader [COMP: \"{}\"]", filePath));
+	GL_LOG_MINIMAL(std::format("Compiling Compute shader [COMP: \"{}\"]", filePath));
 	std::string compSource = utils::readFile(filePath);
 	types::ShaderObject compute = types::ShaderObject(GL_COMPUTE_SHADER, compSource, utils::getFilename(filePath));
 	
@@ -137,13 +107,14 @@ int computeShader(std::string filePath) {
 
 	int shaderID = shared::numberOfShaders;
 	shared::shaders[shared::numberOfShaders++].createProgram(shaders, ST_COMPUTE);
+	shared::shaders[shaderID].name = utils::getFilename(filePath);
 	return shaderID; //Shader reference for the python module.
 }
 
 
 int screenspaceShader(std::string filePath) {
 	//For screenspace shaders.
-	utils::cout(std::format("Compiling Screenspace shader [FRAG: \"{}\"]", filePath));
+	GL_LOG_MINIMAL(std::format("Compiling Screenspace shader [FRAG: \"{}\"]", filePath));
 	std::string vertexSource = R"(
 /* screenspace.vert */
 #version 460 core
@@ -174,13 +145,14 @@ void main() {
 
 	int shaderID = shared::numberOfShaders;
 	shared::shaders[shared::numberOfShaders++].createProgram(shaders, ST_SCREENSPACE);
+	shared::shaders[shaderID].name = utils::getFilename(filePath);
 	return shaderID; //Shader reference for the python module.
 }
 
 
 int worldspaceShader(std::string vertexFilePath, std::string fragmentFilePath) {
 	//For shaders that draw onto triangles.
-	utils::cout(std::format("Compiling Worldpsace shader [VERT: \"{}\", FRAG: \"{}\"]", vertexFilePath, fragmentFilePath));
+	GL_LOG_MINIMAL(std::format("Compiling Worldpsace shader [VERT: \"{}\", FRAG: \"{}\"]", vertexFilePath, fragmentFilePath));
 	std::string vertexSource = utils::readFile(vertexFilePath);
 	types::ShaderObject vertex = types::ShaderObject(GL_VERTEX_SHADER, vertexSource, utils::getFilename(vertexFilePath));
 
@@ -192,6 +164,7 @@ int worldspaceShader(std::string vertexFilePath, std::string fragmentFilePath) {
 
 	int shaderID = shared::numberOfShaders;
 	shared::shaders[shared::numberOfShaders++].createProgram(shaders, ST_WORLDSPACE);
+	shared::shaders[shaderID].name = std::format("{} + {}", utils::getFilename(vertexFilePath), utils::getFilename(fragmentFilePath));
 	return shaderID; //Shader reference for the python module.
 }
 
@@ -204,31 +177,31 @@ namespace config {
 //Different types of shaders.
 void computeShader() {
 	//For compute shaders.
-	utils::cout("Configuring OpenGL for [ST_COMPUTE]");
-	glDisable(GL_BLEND);
+	GL_LOG_MINIMAL("Configuring OpenGL for [ST_COMPUTE]");
+	glstate::setCapability(glstate::CAP_BLEND, false);
 }
 
 
 void screenspaceShader() {
 	//For screenspace shaders, 2D.
-	utils::cout("Configuring OpenGL for [ST_SCREENSPACE]");
-	glDisable(GL_DEPTH_TEST);
-	glEnable(GL_BLEND);
-	glDisable(GL_CULL_FACE);
+	GL_LOG_MINIMAL("Configuring OpenGL for [ST_SCREENSPACE]");
+	glstate::setCapability(glstate::CAP_DEPTH_TEST, false);
+	glstate::setCapability(glstate::CAP_BLEND, true);
+	glstate::setCapability(glstate::CAP_CULL_FACE, false);
 
 }
 
 
 void worldspaceShader(bool cull) {
 	//For shaders that draw onto triangles, 3D.
-	utils::cout("Configuring OpenGL for [ST_WORLDSPACE]");
-	glEnable(GL_DEPTH_TEST);
-	glDepthFunc(GL_LESS);
-	glDepthMask(GL_TRUE);
-	glClearDepth(1.0f);
-
-	glEnable(GL_BLEND);
-	if (cull) {glEnable(GL_CULL_FACE);}
+	GL_LOG_MINIMAL("Configuring OpenGL for [ST_WORLDSPACE]");
+	glstate::setCapability(glstate::CAP_DEPTH_TEST, true);
+	glstate::setDepthFunc(GL_LESS);
+	glstate::setDepthMask(true);
+	glstate::setClearDepth(1.0f);
+
+	glstate::setCapability(glstate::CAP_BLEND, true);
+	if (cull) {glstate::setCapability(glstate::CAP_CULL_FACE, true);}
 }
 
 }
@@ -237,16 +210,21 @@ void worldspaceShader(bool cull) {
 inline bool IDnotInRange(int ID, size_t max) {return (ID < 0) || (ID >= static_cast<int>(max));}
 
 
+//The context is current on one thread only. Some calls release the GIL, so other Python threads
+//can run meanwhile; they must not touch GL objects.
+void checkContextThread(const char* caller) {
+	if (shared::init && (std::this_thread::get_id() != shared::contextThread)) {
+		utils::cerr(std::format("gl.{}() must be called from the thread that called gl.init()", caller));
+	}
+}
+
+
 namespace matrices {
 
 
 
 glm::mat4 getPerspectiveMatrix(int cameraID) {
-	types::Camera& camera = shared::cameras[cameraID];
-
-	float aspectRatio = float(shared::windowResolution.x) / float(shared::windowResolution.y);
-	float verticalFOV = 2 * atan(tan(camera.FOV * 0.5f) / aspectRatio);
-	return glm::perspective(verticalFOV, aspectRatio, camera.nearZ, camera.farZ);
+	return shared::cameras[cameraID].matrices(shared::windowResolution).projection;
 }
 
 glm::mat4 getOrthographicMatrix() {
@@ -254,18 +232,7 @@ glm::mat4 getOrthographicMatrix() {
 }
 
 glm::mat4 getViewMatrix(int cameraID) {
-	types::Camera& camera = shared::cameras[cameraID];
-
-	float sx = sin(camera.angle.x), cx = cos(camera.angle.x);
-	float sy = sin(camera.angle.y), cy = cos(camera.angle.y);
-	glm::vec3 forward = glm::vec3(
-		sx*cy, cx*cy, sy
-	);
-
-	camera.forward = forward;
-	camera.right = glm::cross(forward, camera.up);
-
-	return glm::lookAt(camera.position, camera.position + forward, camera.up);
+	return shared::cameras[cameraID].matrices(shared::windowResolution).view;
 }
 
 glm::mat4 getModelMatrix(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale) {
@@ -297,18 +264,25 @@ glm::mat4 getModelMatrix(glm::vec3 position, glm::vec3 rotation, glm::vec3 scale
 }
 
 
+//getModelMatrix() for count objects at once, see simd::modelMatrices().
+void getModelMatrices(const float* positions, const float* rotations, const float* scales, float* out, size_t count) {
+	PROFILE_ZONE("model_matrices");
+	simd::modelMatrices(positions, rotations, scales, out, count);
+}
+
+
 //Manager func
 glm::mat4 getMatrix(MatrixType type, int cameraID, glm::vec3 position, glm::vec3 rotation, glm::vec3 scale) {
 	//Get matrix of type with data.
 	//To be displayed if necessary. [OOR = Out-Of-Range]
 	bool cameraID_OOR = IDnotInRange(cameraID, constants::misc::MAX_CAMERAS);
-	std::string cameraID_OORmsg = std::format("Camera ID [{}] is invalid : Out of range [0 - {}]", cameraID, constants::misc::MAX_CAMERAS);
+	auto cameraID_OORmsg = [cameraID]() {return std::format("Camera ID [{}] is invalid : Out of range [0 - {}]", cameraID, constants::misc::MAX_CAMERAS);};
 
 	switch (type) {
 		case MAT_IDENTITY: {return glm::mat4(1.0f); /* Simple identity matrix. */}
 
 		case MAT_PERSPECTIVE: {
-			if (cameraID_OOR) {utils::cerr(cameraID_OORmsg);}
+			if (cameraID_OOR) {utils::cerr(cameraID_OORmsg());}
 			return getPerspectiveMatrix(cameraID);
 			break;
 		}
@@ -319,7 +293,7 @@ glm::mat4 getMatrix(MatrixType type, int cameraID, glm::vec3 position, glm::vec3
 		}
 
 		case MAT_VIEW: {
-			if (cameraID_OOR) {utils::cerr(cameraID_OORmsg);}
+			if (cameraID_OOR) {utils::cerr(cameraID_OORmsg());}
 			return getViewMatrix(cameraID);
 			break;
 		}
@@ -360,7 +334,7 @@ int assign(
 	}
 
 	bool useRad = FOVradians > 0.0f;
-	if (!useRad && (FOVdegrees <= 0.0f)) {utils::cout(std::format(
+	if (!useRad && (FOVdegrees <= 0.0f)) {GL_LOG_MINIMAL(std::format(
 		"Warning : Camera [{}] FOV is 0.", shared::numberOfCameras
 	));}
 
@@ -382,6 +356,7 @@ glm::vec3 getDirection(int cameraID, CameraDirection cDir) {
 		utils::cerr(std::format("Camera ID [{}] is invalid : Was never initialised, or was destroyed.", cameraID));
 	}
 
+	shared::cameras[cameraID].refreshBasis(); //Follows the angle even if no view matrix was asked for.
 	switch (cDir) {
 		case CD_FORWARD: {
 			return shared::cameras[cameraID].forward;
@@ -410,7 +385,7 @@ void setPosition(int cameraID, glm::vec3 position) {
 		utils::cerr(std::format("Camera ID [{}] is invalid : Was never initialised, or was destroyed.", cameraID));
 	}
 
-	shared::cameras[cameraID].position = position;
+	shared::cameras[cameraID].setPosition(position);
 }
 
 
@@ -422,7 +397,7 @@ void setAngle(int cameraID, glm::vec3 angle) {
 		utils::cerr(std::format("Camera ID [{}] is invalid : Was never initialised, or was destroyed.", cameraID));
 	}
 
-	shared::cameras[cameraID].angle = angle;
+	shared::cameras[cameraID].setAngle(angle);
 }
 
 
@@ -435,7 +410,7 @@ void setFOV(int cameraID, float FOVdegrees, float FOVradians) {
 	}
 
 	bool useRad = FOVradians > 0.0f;
-	if (!useRad && (FOVdegrees <= 0.0f)) {utils::cout(std::format(
+	if (!useRad && (FOVdegrees <= 0.0f)) {GL_LOG_MINIMAL(std::format(
 		"Warning : Camera [{}] FOV is 0.", cameraID
 	));}
 
@@ -443,7 +418,7 @@ void setFOV(int cameraID, float FOVdegrees, float FOVradians) {
 	float fovFract = (useRad) ? (FOVradians / constants::maths::PI) : (FOVdegrees / 180.0f);
 	float fov = glm::fract(abs(fovFract)) * constants::maths::PI;
 
-	shared::cameras[cameraID].FOV = fov;
+	shared::cameras[cameraID].setFOV(fov);
 }
 
 
@@ -459,8 +434,20 @@ void setZclip(int cameraID, float zNear, float zFar) {
 		utils::cerr(std::format("Near plane [{}] must be closer than the far plane [{}].", zNear, zFar));
 	}
 
-	shared::cameras[cameraID].nearZ = zNear;
-	shared::cameras[cameraID].farZ = zFar;
+	shared::cameras[cameraID].setClip(zNear, zFar);
+}
+
+
+//Every matrix of the camera, from its cache (only rebuilt if something changed since last asked).
+const types::Camera::Matrices& getMatrices(int cameraID) {
+	if (IDnotInRange(cameraID, constants::misc::MAX_CAMERAS)) {
+		utils::cerr(std::format("Camera ID [{}] is invalid : Out of range [0 - {}]", cameraID, constants::misc::MAX_CAMERAS));
+	}
+	if (!(shared::cameras[cameraID].isValid())) {
+		utils::cerr(std::format("Camera ID [{}] is invalid : Was never initialised, or was destroyed.", cameraID));
+	}
+
+	return shared::cameras[cameraID].matrices(shared::windowResolution);
 }
 
 
@@ -476,6 +463,22 @@ void remove(int cameraID) {
 }
 
 
+//visible[i] = 1 if object i is (at least partly) in the camera's view. stride 4: spheres, 6: AABBs.
+void cull(int cameraID, const float* bounds, size_t count, size_t stride, uint8_t* visible) {
+	PROFILE_ZONE("cull");
+	if (IDnotInRange(cameraID, constants::misc::MAX_CAMERAS)) {
+		utils::cerr(std::format("Camera ID [{}] is invalid : Out of range [0 - {}]", cameraID, constants::misc::MAX_CAMERAS));
+	}
+	if (!(shared::cameras[cameraID].isValid())) {
+		utils::cerr(std::format("Camera ID [{}] is invalid : Was never initialised, or was destroyed.", cameraID));
+	}
+
+	const glm::mat4& projView = shared::cameras[cameraID].matrices(shared::windowResolution).viewProjection;
+	simd::Frustum frustum = simd::extractFrustum(glm::value_ptr(projView));
+	simd::cull(bounds, count, stride, frustum, visible);
+}
+
+
 }
 
 
@@ -485,6 +488,8 @@ void remove(int cameraID) {
 namespace texture {
 
 int load(std::string filePath, std::string name) {
+	PROFILE_ZONE("load_texture");
+	checkContextThread("load_texture");
 	if (shared::numberOfTextures >= constants::misc::MAX_TEXTURES) {
 		utils::cerr(std::format(
 			"Exceeded maximum number of allowed textures [{} > {}]",
@@ -533,6 +538,7 @@ int load(std::string filePath, std::string name) {
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, tex.wrap.second);
 
 	glBindTexture(GL_TEXTURE_2D, 0);
+	glstate::invalidateTextureUnit(0); //Non-DSA binds go through the active unit, always 0 here.
 	stbi_image_free(textureData); //Free STBI image in memory
 
 
@@ -543,6 +549,7 @@ int load(std::string filePath, std::string name) {
 
 
 int create(glm::ivec2 resolution, glm::vec4 fillColour, std::string name) {
+	checkContextThread("create_texture");
 	if (shared::numberOfTextures >= constants::misc::MAX_TEXTURES) {
 		utils::cerr(std::format(
 			"Exceeded maximum number of allowed textures [{} > {}]",
@@ -576,6 +583,7 @@ int create(glm::ivec2 resolution, glm::vec4 fillColour, std::string name) {
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, tex.wrap.second);
 
 	glBindTexture(GL_TEXTURE_2D, 0);
+	glstate::invalidateTextureUnit(0); //Non-DSA binds go through the active unit, always 0 here.
 
 
 	tex.label();
@@ -584,7 +592,7 @@ int create(glm::ivec2 resolution, glm::vec4 fillColour, std::string name) {
 }
 
 
-bool bind(int shaderID, int textureID, int binding) {
+bool bind(int shaderID, int textureID, int binding, ImageAccess access) {
 	if (IDnotInRange(shaderID, constants::misc::MAX_SHADERS)) {
 		utils::cerr(std::format("Shader ID [{}] is invalid : Out of range [0 - {}]", shaderID, constants::misc::MAX_SHADERS));
 	}
@@ -594,12 +602,14 @@ bool bind(int shaderID, int textureID, int binding) {
 
 
 	return shared::shaders[shaderID].bindTexture(
-		binding, shared::textures[textureID]
+		binding, shared::textures[textureID], access
 	);
 }
 
 
 void save(int textureID, std::string filePath) {
+	PROFILE_ZONE("save_texture");
+	checkContextThread("save_texture");
 	if (IDnotInRange(textureID, constants::misc::MAX_TEXTURES)) {
 		utils::cerr(std::format("Texture ID [{}] is invalid : Out of range [0 - {}]", textureID, constants::misc::MAX_TEXTURES));
 	}
@@ -609,6 +619,7 @@ void save(int textureID, std::string filePath) {
 	std::vector<unsigned char> pixels(tex.resolution.x * tex.resolution.y * iRF.channels);
 
 	//Take texture data from GPU
+	barriers::beforeReadback(tex);
 	glGetTextureImage(
 		tex.GLindex, 0, iRF.format,
 		GL_UNSIGNED_BYTE, pixels.size(), pixels.data()
@@ -624,6 +635,7 @@ void save(int textureID, std::string filePath) {
 
 
 void remove(int textureID) {
+	checkContextThread("delete_texture");
 	if (IDnotInRange(textureID, constants::misc::MAX_TEXTURES)) {
 		utils::cerr(std::format("Texture ID [{}] is invalid : Out of range [0 - {}]", textureID, constants::misc::MAX_TEXTURES));
 	}
@@ -631,6 +643,149 @@ void remove(int textureID) {
 	shared::textures[textureID].destroy();
 }
 
+
+
+int createPair(int frontID, int backID, std::string name) {
+	if (shared::numberOfTexturePairs >= constants::misc::MAX_TEXTURE_PAIRS) {
+		utils::cerr(std::format(
+			"Exceeded maximum number of allowed texture pairs [{} > {}]",
+			shared::numberOfTexturePairs, constants::misc::MAX_TEXTURE_PAIRS
+		));
+	}
+	if (IDnotInRange(frontID, constants::misc::MAX_TEXTURES)) {
+		utils::cerr(std::format("Texture ID [{}] is invalid : Out of range [0 - {}]", frontID, constants::misc::MAX_TEXTURES));
+	}
+	if (IDnotInRange(backID, constants::misc::MAX_TEXTURES)) {
+		utils::cerr(std::format("Texture ID [{}] is invalid : Out of range [0 - {}]", backID, constants::misc::MAX_TEXTURES));
+	}
+	if (frontID == backID) {
+		utils::cerr(std::format("Texture pair needs 2 different textures, got [{}] twice.", frontID));
+	}
+
+	types::Texture& front = shared::textures[frontID];
+	types::Texture& back = shared::textures[backID];
+	if (!front.isValid() || !back.isValid()) {
+		utils::cerr(std::format("Texture pair [{}, {}] contains an invalid texture.", frontID, backID));
+	}
+	if ((front.resolution != back.resolution) || (front.format != back.format) || (front.sampler2D != back.sampler2D)) {
+		//Both sides must be interchangeable, or a swap would change what the shader sees.
+		utils::cerr(std::format("Textures [{}, {}] must share resolution, format and type to be paired.", frontID, backID));
+	}
+
+	GL_LOG_MINIMAL(std::format("Creating texture pair [FRONT: {}, BACK: {}]", frontID, backID));
+	shared::texturePairs[shared::numberOfTexturePairs].assign(front, back, name);
+	return shared::numberOfTexturePairs++;
+}
+
+
+bool bindPair(int shaderID, int pairID, int binding, PairSide side, ImageAccess access) {
+	if (IDnotInRange(shaderID, constants::misc::MAX_SHADERS)) {
+		utils::cerr(std::format("Shader ID [{}] is invalid : Out of range [0 - {}]", shaderID, constants::misc::MAX_SHADERS));
+	}
+	if (IDnotInRange(pairID, constants::misc::MAX_TEXTURE_PAIRS)) {
+		utils::cerr(std::format("Texture pair ID [{}] is invalid : Out of range [0 - {}]", pairID, constants::misc::MAX_TEXTURE_PAIRS));
+	}
+
+
+	return shared::shaders[shaderID].bindTexturePair(
+		binding, shared::texturePairs[pairID], side, access
+	);
+}
+
+
+void swapPair(int pairID) {
+	if (IDnotInRange(pairID, constants::misc::MAX_TEXTURE_PAIRS)) {
+		utils::cerr(std::format("Texture pair ID [{}] is invalid : Out of range [0 - {}]", pairID, constants::misc::MAX_TEXTURE_PAIRS));
+	}
+	types::TexturePair& pair = shared::texturePairs[pairID];
+	if (!pair.isValid()) {
+		utils::cerr(std::format("Texture pair ID [{}] is invalid : Was never initialised, or was destroyed.", pairID));
+	}
+
+	pair.swap();
+}
+
+
+void removePair(int pairID) {
+	if (IDnotInRange(pairID, constants::misc::MAX_TEXTURE_PAIRS)) {
+		utils::cerr(std::format("Texture pair ID [{}] is invalid : Out of range [0 - {}]", pairID, constants::misc::MAX_TEXTURE_PAIRS));
+	}
+	types::TexturePair& pair = shared::texturePairs[pairID];
+	if (!pair.isValid()) {
+		utils::cerr(std::format("Texture pair ID [{}] is invalid : Was never initialised, or was destroyed.", pairID));
+	}
+
+	pair.destroy();
+}
+
+}
+
+
+
+
+
+
+namespace framebuffer {
+
+
+int create(std::vector<int> textureIDs, bool depth, std::string name) {
+	checkContextThread("create_framebuffer");
+	if (shared::numberOfFramebuffers >= constants::misc::MAX_FRAMEBUFFERS) {
+		utils::cerr(std::format(
+			"Exceeded maximum number of allowed framebuffers [{} > {}]",
+			shared::numberOfFramebuffers, constants::misc::MAX_FRAMEBUFFERS
+		));
+	}
+	if (textureIDs.empty() || (textureIDs.size() > constants::misc::MAX_COLOUR_ATTACHMENTS)) {
+		utils::cerr(std::format("Framebuffer needs [1 - {}] colour textures, got [{}].", constants::misc::MAX_COLOUR_ATTACHMENTS, textureIDs.size()));
+	}
+
+	std::vector<types::Texture*> textures;
+	for (int textureID : textureIDs) {
+		if (IDnotInRange(textureID, constants::misc::MAX_TEXTURES)) {
+			utils::cerr(std::format("Texture ID [{}] is invalid : Out of range [0 - {}]", textureID, constants::misc::MAX_TEXTURES));
+		}
+		types::Texture& tex = shared::textures[textureID];
+		if (!tex.isValid()) {
+			utils::cerr(std::format("Texture ID [{}] is invalid : Was never initialised, or was destroyed.", textureID));
+		}
+		if (!textures.empty() && (tex.resolution != textures.front()->resolution)) {
+			utils::cerr(std::format("Texture ID [{}] does not match the resolution of the other framebuffer textures.", textureID));
+		}
+		textures.push_back(&tex);
+	}
+
+	GL_LOG_MINIMAL(std::format("Creating framebuffer with [{}] colour textures{}", textures.size(), (depth) ? " and depth" : ""));
+	shared::framebuffers[shared::numberOfFramebuffers].create(textures, depth, name);
+	return shared::numberOfFramebuffers++;
+}
+
+
+void clear(int framebufferID, glm::vec4 colour, float depth) {
+	checkContextThread("clear_framebuffer");
+	if (IDnotInRange(framebufferID, constants::misc::MAX_FRAMEBUFFERS)) {
+		utils::cerr(std::format("Framebuffer ID [{}] is invalid : Out of range [0 - {}]", framebufferID, constants::misc::MAX_FRAMEBUFFERS));
+	}
+	types::Framebuffer& fb = shared::framebuffers[framebufferID];
+	if (!fb.isValid()) {
+		utils::cerr(std::format("Framebuffer ID [{}] is invalid : Was never initialised, or was destroyed.", framebufferID));
+	}
+
+	barriers::beforeRender(fb);
+	fb.clear(colour, depth);
+}
+
+
+void remove(int framebufferID) {
+	checkContextThread("delete_framebuffer");
+	if (IDnotInRange(framebufferID, constants::misc::MAX_FRAMEBUFFERS)) {
+		utils::cerr(std::format("Framebuffer ID [{}] is invalid : Out of range [0 - {}]", framebufferID, constants::misc::MAX_FRAMEBUFFERS));
+	}
+
+	shared::framebuffers[framebufferID].destroy();
+}
+
+
 }
 
 
@@ -642,6 +797,8 @@ namespace shader {
 
 
 int load(ShaderType type, std::string vertex, std::string fragment, std::string compute) {
+	PROFILE_ZONE("load_shader");
+	checkContextThread("load_shader");
 	if (!shared::init) {
 		utils::cerr("You need to initialise GL first → gl.init()");
 		return -1;
@@ -658,6 +815,8 @@ int load(ShaderType type, std::string vertex, std::string fragment, std::string
 
 
 void configure(ShaderType type, bool cull) {
+	PROFILE_ZONE("configure");
+	checkContextThread("configure");
 	if (!shared::init) {
 		utils::cerr("You need to initialise GL first → gl.init()");
 		return;
@@ -675,36 +834,23 @@ void configure(ShaderType type, bool cull) {
 
 
 bool addUniformValue(int shaderID, std::string uniformName, py::object value) {
+	PROFILE_ZONE("add_uniform_value");
 	if (IDnotInRange(shaderID, constants::misc::MAX_SHADERS)) {
 		utils::cerr(std::format("Shader ID [{}] is invalid : Out of range [0 - {}]", shaderID, constants::misc::MAX_SHADERS));
 	}
 
 	types::ShaderProgram* shader = &(shared::shaders[shaderID]);
-	utils::cout(std::format(
+	GL_LOG_MINIMAL(std::format(
 		"Added/Updated uniform \"{}\": [{}]",
 		uniformName, //Name of the uniform being assigned
 		std::string(py::str(py::type::of(value))) //Type of the uniform
 	));
-	utils::cout_inline(V_DEBUG, std::string(py::str(value))); //Value being assigned
+	GL_LOG_DEBUG(std::format("Value: {}", std::string(py::str(value)))); //Value being assigned
 
 
 	try {
-		//1D values
-		if (py::isinstance<py::int_>(value)) {shader->setUniform(uniformName, value.cast<int>()); return true;}
-		if (py::isinstance<py::float_>(value)) {shader->setUniform(uniformName, value.cast<float>()); return true;}
-		if (py::isinstance<py::bool_>(value)) {shader->setUniform(uniformName, value.cast<bool>()); return true;}
-
-		//Vectors
-		try {shader->setUniform(uniformName, value.cast<glm::vec2>()); return true;} catch(...) {}
-		try {shader->setUniform(uniformName, value.cast<glm::vec3>()); return true;} catch(...) {}
-		try {shader->setUniform(uniformName, value.cast<glm::vec4>()); return true;} catch(...) {}
-
-		//Matrices
-		glm::mat3 mat3; glm::mat4 mat4;
-		if (castMat3(value, mat3)) {shader->setUniform(uniformName, mat3); return true;}
-		if (castMat4(value, mat4)) {shader->setUniform(uniformName, mat4); return true;}
-
-
+		types::UniformValue uniform;
+		if (castUniform(value, uniform)) {shader->setUniform(uniformName, uniform); return true;}
 	} catch (const py::cast_error& e) {
 		utils::cerr(std::format("Failed to cast uniform {}: {}", uniformName, e.what()));
 		return false;
@@ -715,42 +861,811 @@ bool addUniformValue(int shaderID, std::string uniformName, py::object value) {
 }
 
 
-bool addVAO(int shaderID, VAOFormat format, std::vector<float> vertices, std::vector<int> indicesSigned) {
+//Reorder for the vertex cache, overdraw and fetch locality (see meshopt.h), and log how the cache did.
+meshopt::Stats optimizeVertices(VAOFormat format, std::vector<float>& vertices, std::vector<GLuint>& indices) {
+	PROFILE_ZONE("optimize_mesh");
+	meshopt::Stats stats = meshopt::optimize(vertices, constants::display::vertexFormatSizeMap.at(format), indices);
+	GL_LOG_MINIMAL(std::format("Optimised mesh, ACMR [{:.3f}] -> [{:.3f}]", stats.acmrBefore, stats.acmrAfter));
+	return stats;
+}
+
+
+bool addVAO(int shaderID, VAOFormat format, std::vector<float> vertices, std::vector<GLuint> indices, bool optimize, VertexPacking packing) {
+	checkContextThread("add_vao");
 	if (IDnotInRange(shaderID, constants::misc::MAX_SHADERS)) {
 		utils::cerr(std::format("Shader ID [{}] is invalid : Out of range [0 - {}]", shaderID, constants::misc::MAX_SHADERS));
 	}
-	std::vector<GLuint> indicesUnsigned = std::vector<GLuint>(indicesSigned.begin(), indicesSigned.end());
-	shared::shaders[shaderID].setVAO(format, vertices, indicesUnsigned);
+	if (optimize) {optimizeVertices(format, vertices, indices);}
+	shared::shaders[shaderID].setVAO(format, vertices, indices, packing);
 	return true;
 }
 
 
-bool run(int shaderID, glm::uvec3 dispatchSize) {
+//Vertices as the user laid them out, read straight from their buffers.
+bool addVAOLayout(int shaderID, const std::vector<vertexpack::AttributeFormat>& attributes, const std::vector<vertexpack::VertexStream>& streams, std::vector<GLuint> indices) {
+	checkContextThread("add_vao");
+	if (IDnotInRange(shaderID, constants::misc::MAX_SHADERS)) {
+		utils::cerr(std::format("Shader ID [{}] is invalid : Out of range [0 - {}]", shaderID, constants::misc::MAX_SHADERS));
+	}
+	shared::shaders[shaderID].setVAOLayout(attributes, streams, indices);
+	return true;
+}
+
+
+//Parse a .obj/.glb file and upload it as the shader's vertices, in whichever VAOFormat fits what the file has.
+mesh::Info loadMesh(int shaderID, std::string filePath, bool optimize, VertexPacking packing) {
+	PROFILE_ZONE("load_mesh");
+	checkContextThread("load_mesh");
+	if (IDnotInRange(shaderID, constants::misc::MAX_SHADERS)) {
+		utils::cerr(std::format("Shader ID [{}] is invalid : Out of range [0 - {}]", shaderID, constants::misc::MAX_SHADERS));
+	}
+
+	mesh::Mesh loaded;
+	{PROFILE_ZONE("parse_mesh"); loaded = mesh::load(filePath);}
+	GL_LOG_MINIMAL(std::format(
+		"Loaded mesh [{}] with [{}] vertices and [{}] indices",
+		filePath, loaded.vertexCount(), loaded.indices.size()
+	));
+
+	meshopt::Stats stats;
+	if (optimize) {stats = optimizeVertices(loaded.format, loaded.vertices, loaded.indices);}
+	else {stats.acmrBefore = stats.acmrAfter = meshopt::acmr(loaded.indices, loaded.vertexCount(), constants::misc::VERTEX_CACHE_SIZE);}
+
+	shared::shaders[shaderID].setVAO(loaded.format, loaded.vertices, loaded.indices, packing);
+	mesh::Info info = loaded.info();
+	info.acmrBefore = stats.acmrBefore;
+	info.acmrAfter = stats.acmrAfter;
+	return info;
+}
+
+
+//Checks a run's IDs, returns its render target (nullptr for the screen).
+types::Framebuffer* validateRun(int shaderID, int targetID) {
 	if (IDnotInRange(shaderID, constants::misc::MAX_SHADERS)) {
 		utils::cerr(std::format("Shader ID [{}] is invalid : Out of range [0 - {}]", shaderID, constants::misc::MAX_SHADERS));
 	}
 	types::ShaderProgram& shader = shared::shaders[shaderID];
 
+	types::Framebuffer* target = nullptr;
+	if (targetID >= 0) {
+		if (IDnotInRange(targetID, constants::misc::MAX_FRAMEBUFFERS)) {
+			utils::cerr(std::format("Framebuffer ID [{}] is invalid : Out of range [0 - {}]", targetID, constants::misc::MAX_FRAMEBUFFERS));
+		}
+		if (shader.type == ST_COMPUTE) {
+			utils::cerr(std::format("Shader ID [{}] is ST_COMPUTE, it can't render into framebuffer [{}].", shaderID, targetID));
+		}
+		target = &(shared::framebuffers[targetID]);
+		if (!target->isValid()) {
+			utils::cerr(std::format("Framebuffer ID [{}] is invalid : Was never initialised, or was destroyed.", targetID));
+		}
+	}
+	return target;
+}
+
+
+//Checks meshes can be drawn by this (already validated) shader.
+std::vector<const types::Mesh*> validateMeshes(int shaderID, const std::vector<int>& meshIDs) {
+	if (shared::shaders[shaderID].type != ST_WORLDSPACE) {
+		utils::cerr(std::format("Shader ID [{}] isn't ST_WORLDSPACE, only worldspace shaders draw meshes.", shaderID));
+	}
+	std::vector<const types::Mesh*> out;
+	out.reserve(meshIDs.size());
+	for (int meshID : meshIDs) {
+		if (IDnotInRange(meshID, constants::misc::MAX_MESHES)) {
+			utils::cerr(std::format("Mesh ID [{}] is invalid : Out of range [0 - {}]", meshID, constants::misc::MAX_MESHES));
+		}
+		const types::Mesh& mesh = shared::meshes[meshID];
+		if (!mesh.isValid()) {
+			utils::cerr(std::format("Mesh ID [{}] is invalid : Was never created, or was deleted.", meshID));
+		}
+		out.push_back(&mesh);
+	}
+	return out;
+}
+
+
+//Set the built-in uniforms the shader declared, straight from the module's state. Needs the program in use.
+void applyBuiltins(const types::ShaderProgram& shader, const types::Framebuffer* target) {
+	const types::BuiltinUniforms& builtins = shader.builtins();
+
+	if (builtins.time != -1) {
+		std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - shared::startTime;
+		glUniform1f(builtins.time, elapsed.count());
+	}
+	if (builtins.frame != -1) {
+		if (builtins.frameType == GL_UNSIGNED_INT) {glUniform1ui(builtins.frame, static_cast<GLuint>(shared::frameIndex));}
+		else {glUniform1i(builtins.frame, static_cast<GLint>(shared::frameIndex));}
+	}
+	glm::ivec2 resolution = (target) ? target->resolution : shared::windowResolution;
+	if (builtins.resolution != -1) {
+		if (builtins.resolutionType == GL_INT_VEC2) {glUniform2i(builtins.resolution, resolution.x, resolution.y);}
+		else {glUniform2f(builtins.resolution, float(resolution.x), float(resolution.y));}
+	}
+	if (builtins.viewProj != -1) {
+		//Element i is camera ID i, identity where there's no such camera. Aspect ratio from the target drawn to, like u_resolution.
+		thread_local std::array<glm::mat4, constants::misc::MAX_CAMERAS> viewProj;
+		for (GLsizei i=0; i<builtins.viewProjCount; i++) {
+			types::Camera& camera = shared::cameras[i];
+			viewProj[i] = (camera.isValid()) ? camera.matrices(resolution).viewProjection : glm::mat4(1.0f);
+		}
+		glUniformMatrix4fv(builtins.viewProj, builtins.viewProjCount, GL_FALSE, glm::value_ptr(viewProj[0]));
+	}
+}
+
+
+//Run an already validated shader.
+bool execute(int shaderID, glm::uvec3 dispatchSize, types::Framebuffer* target, std::span<const types::Mesh* const> meshes) {
+	types::ShaderProgram& shader = shared::shaders[shaderID];
+
 	shader.use();
-	shader.applyTextures();
-	shader.applyUniforms();
-	return shader.run(dispatchSize, shaderID);
+	{PROFILE_ZONE("apply_textures"); shader.applyTextures();}
+	if (shader.builtins().any()) {PROFILE_ZONE("apply_builtins"); applyBuiltins(shader, target);}
+	{PROFILE_ZONE("apply_uniforms"); shader.applyUniforms(); /* After the built-ins, so the user's values win. */}
+
+	if (target) {
+		barriers::beforeRender(*target);
+		target->bind();
+	} else {
+		//The screen. Only reaches the driver if a target was bound since.
+		glstate::bindFramebuffer(shared::defaultFramebuffer);
+		glstate::setViewport(shared::windowResolution);
+	}
+	barriers::beforeRun(shader, shaderID); //Last, every barrier before it covers only earlier runs.
+
+	if (timing::gpuEnabled) {timing::shaderTimers[shaderID].begin(shaderID);}
+	bool success = shader.run(dispatchSize, shaderID, meshes);
+	if (timing::gpuEnabled) {timing::shaderTimers[shaderID].end();}
+	barriers::afterRun(shader, shaderID);
+	return success;
+}
+
+
+bool run(int shaderID, glm::uvec3 dispatchSize, int targetID, int meshID) {
+	PROFILE_ZONE("run");
+	checkContextThread("run");
+	types::Framebuffer* target = validateRun(shaderID, targetID);
+	if (meshID < 0) {return execute(shaderID, dispatchSize, target);}
+	std::vector<const types::Mesh*> meshes = validateMeshes(shaderID, {meshID});
+	return execute(shaderID, dispatchSize, target, meshes);
+}
+
+
+//One run of the shader over many meshes: program, textures & uniforms are set once, then a draw per mesh.
+bool draw(int shaderID, std::vector<int> meshIDs, int targetID) {
+	PROFILE_ZONE("draw");
+	checkContextThread("draw");
+	types::Framebuffer* target = validateRun(shaderID, targetID);
+	std::vector<const types::Mesh*> meshes = validateMeshes(shaderID, meshIDs);
+	if (meshes.empty()) {return true; /* Nothing to draw, not even the shader's own vertices. */}
+	return execute(shaderID, glm::uvec3(0u), target, meshes);
+}
+
+
+void enableGPUTiming(bool enabled) {
+	GL_LOG_MINIMAL(std::format("{} GPU timing of shader runs", (enabled) ? "Enabled" : "Disabled"));
+	timing::gpuEnabled = enabled;
+}
+
+
+std::map<int, timing::GPUStats> getGPUTimings() {
+	checkContextThread("get_gpu_timings");
+	//Gather whatever has finished, without waiting on the rest.
+	std::map<int, timing::GPUStats> out;
+	for (size_t ID=0; ID<shared::numberOfShaders; ID++) {
+		timing::GPUTimer& timer = timing::shaderTimers[ID];
+		timer.collect();
+		if (timer.hasSamples()) {out[static_cast<int>(ID)] = timer.stats();}
+	}
+	return out;
+}
+
+
+void setBarrierMode(BarrierMode mode) {
+	GL_LOG_MINIMAL(std::format("Set barrier mode to [{}]", static_cast<int>(mode)));
+	barriers::mode = mode;
+}
+
+
+uint64_t barrierCount() {
+	checkContextThread("get_barrier_count");
+	return barriers::issuedCount;
+}
+
+
+}
+
+
+
+
+
+
+namespace geometry {
+
+
+int reserve() {
+	if (shared::numberOfMeshes >= constants::misc::MAX_MESHES) {
+		utils::cerr(std::format(
+			"Exceeded maximum number of allowed meshes [{} > {}]",
+			shared::numberOfMeshes, constants::misc::MAX_MESHES
+		));
+	}
+	return static_cast<int>(shared::numberOfMeshes);
+}
+
+
+int create(VAOFormat format, std::vector<float> vertices, std::vector<GLuint> indices, bool optimize, VertexPacking packing, std::string name) {
+	PROFILE_ZONE("create_mesh");
+	checkContextThread("create_mesh");
+	int meshID = reserve();
+	if (format == VAO_EMPTY) {utils::cerr("A mesh needs vertices, it can't be VAO_EMPTY");}
+
+	if (optimize) {shader::optimizeVertices(format, vertices, indices);}
+	types::Mesh& mesh = shared::meshes[meshID];
+	mesh.setFormat(format, vertices, indices, packing);
+	mesh.name = name;
+	shared::numberOfMeshes++;
+	return meshID;
+}
+
+
+int createLayout(const std::vector<vertexpack::AttributeFormat>& attributes, const std::vector<vertexpack::VertexStream>& streams, std::vector<GLuint> indices, std::string name) {
+	PROFILE_ZONE("create_mesh");
+	checkContextThread("create_mesh");
+	int meshID = reserve();
+
+	types::Mesh& mesh = shared::meshes[meshID];
+	mesh.setLayout(attributes, streams, indices);
+	mesh.name = name;
+	shared::numberOfMeshes++;
+	return meshID;
+}
+
+
+void remove(int meshID) {
+	checkContextThread("delete_mesh");
+	if (IDnotInRange(meshID, constants::misc::MAX_MESHES)) {
+		utils::cerr(std::format("Mesh ID [{}] is invalid : Out of range [0 - {}]", meshID, constants::misc::MAX_MESHES));
+	}
+	shared::meshes[meshID].destroy();
+	shared::meshes[meshID].name = "";
+}
+
+
+}
+
+
+
+
+
+
+namespace commandList {
+
+
+commands::CommandList& getList(int listID) {
+	if (IDnotInRange(listID, constants::misc::MAX_COMMAND_LISTS)) {
+		utils::cerr(std::format("Command list ID [{}] is invalid : Out of range [0 - {}]", listID, constants::misc::MAX_COMMAND_LISTS));
+	}
+	commands::CommandList& list = commands::lists[listID];
+	if (!list.isValid()) {
+		utils::cerr(std::format("Command list ID [{}] is invalid : Was never initialised, or was destroyed.", listID));
+	}
+	return list;
+}
+
+void checkShader(int shaderID) {
+	if (IDnotInRange(shaderID, constants::misc::MAX_SHADERS)) {
+		utils::cerr(std::format("Shader ID [{}] is invalid : Out of range [0 - {}]", shaderID, constants::misc::MAX_SHADERS));
+	}
+	if (!shared::shaders[shaderID].isLinked()) {
+		utils::cerr(std::format("Shader ID [{}] is invalid : Was never loaded, or was destroyed.", shaderID));
+	}
+}
+
+
+
+int create(std::string name) {
+	if (commands::numberOfLists >= constants::misc::MAX_COMMAND_LISTS) {
+		utils::cerr(std::format(
+			"Exceeded maximum number of allowed command lists [{} > {}]",
+			commands::numberOfLists, constants::misc::MAX_COMMAND_LISTS
+		));
+	}
+
+	GL_LOG_MINIMAL(std::format("Creating command list \"{}\"", name));
+	commands::lists[commands::numberOfLists].create(name);
+	return commands::numberOfLists++;
+}
+
+
+void recordConfigure(int listID, ShaderType type, bool cull) {
+	commands::CommandList& list = getList(listID);
+	if ((type != ST_COMPUTE) && (type != ST_SCREENSPACE) && (type != ST_WORLDSPACE)) {
+		utils::cerr("Unknown shader type. Must be valid ShaderType enum [COMPUTE, SCREENSPACE, WORLDSPACE]");
+	}
+	list.record(commands::Configure{type, cull});
+}
+
+
+void recordRun(int listID, int shaderID, glm::uvec3 dispatchSize, int targetID) {
+	commands::CommandList& list = getList(listID);
+	checkShader(shaderID);
+	shader::validateRun(shaderID, targetID);
+	list.record(commands::Run{shaderID, dispatchSize, targetID});
+}
+
+
+void recordUniform(int listID, int shaderID, std::string uniformName, py::object value) {
+	commands::CommandList& list = getList(listID);
+	checkShader(shaderID);
+
+	types::UniformValue uniform;
+	if (!castUniform(value, uniform)) {
+		utils::cerr(std::format("Unsupported uniform type for '{}'", uniformName));
+	}
+	list.record(commands::Uniform{shaderID, uniformName, uniform});
+}
+
+
+void recordMatrixUniform(
+	int listID, int shaderID, std::string uniformName, std::vector<MatrixType> matrices,
+	int cameraID, glm::vec3 position, glm::vec3 rotation, glm::vec3 scale
+) {
+	commands::CommandList& list = getList(listID);
+	checkShader(shaderID);
+	if (matrices.empty()) {
+		utils::cerr(std::format("Matrix uniform '{}' needs at least 1 matrix type.", uniformName));
+	}
+	for (MatrixType type : matrices) {
+		bool needsCamera = (type == MAT_PERSPECTIVE) || (type == MAT_VIEW);
+		if (needsCamera && (IDnotInRange(cameraID, constants::misc::MAX_CAMERAS) || !shared::cameras[cameraID].isValid())) {
+			utils::cerr(std::format("Camera ID [{}] is invalid : Matrix uniform '{}' needs a valid camera.", cameraID, uniformName));
+		}
+		if ((type < MAT_IDENTITY) || (type > MAT_MODEL)) {
+			utils::cerr("Unknown matrix type. Must be valid MatrixType enum [MAT_PERSPECTIVE, MAT_ORTHOGRAPHIC, MAT_VIEW, MAT_MODEL]");
+		}
+	}
+	list.record(commands::MatrixUniform{shaderID, uniformName, matrices, cameraID, position, rotation, scale});
+}
+
+
+void recordBind(int listID, int shaderID, int textureID, int binding, ImageAccess access) {
+	commands::CommandList& list = getList(listID);
+	checkShader(shaderID);
+	if (IDnotInRange(textureID, constants::misc::MAX_TEXTURES)) {
+		utils::cerr(std::format("Texture ID [{}] is invalid : Out of range [0 - {}]", textureID, constants::misc::MAX_TEXTURES));
+	}
+	if (!shared::textures[textureID].isValid()) {
+		utils::cerr(std::format("Texture ID [{}] is invalid : Was never initialised, or was destroyed.", textureID));
+	}
+	list.record(commands::Bind{shaderID, textureID, binding, access});
+}
+
+
+void recordSwap(int listID, int pairID) {
+	commands::CommandList& list = getList(listID);
+	if (IDnotInRange(pairID, constants::misc::MAX_TEXTURE_PAIRS)) {
+		utils::cerr(std::format("Texture pair ID [{}] is invalid : Out of range [0 - {}]", pairID, constants::misc::MAX_TEXTURE_PAIRS));
+	}
+	if (!shared::texturePairs[pairID].isValid()) {
+		utils::cerr(std::format("Texture pair ID [{}] is invalid : Was never initialised, or was destroyed.", pairID));
+	}
+	list.record(commands::Swap{pairID});
+}
+
+
+void recordBarrier(int listID) {
+	getList(listID).record(commands::Barrier{GL_ALL_BARRIER_BITS});
+}
+
+
+//Replay every command in order. Everything was checked when recorded, so this only does the work.
+bool submit(int listID) {
+	PROFILE_ZONE("submit");
+	checkContextThread("submit");
+	commands::CommandList& list = getList(listID);
+
+	bool success = true;
+	for (const commands::Command& command : list.commands) {
+		std::visit([&success](const auto& c) {
+			using T = std::decay_t<decltype(c)>;
+
+			if constexpr (std::is_same_v<T, commands::Configure>) {
+				shader::configure(c.type, c.cull);
+
+			} else if constexpr (std::is_same_v<T, commands::Run>) {
+				types::Framebuffer* target = nullptr;
+				if (c.targetID >= 0) {
+					target = &(shared::framebuffers[c.targetID]);
+					//Only thing that may have changed since recording.
+					if (!target->isValid()) {utils::cerr(std::format("Framebuffer ID [{}] was destroyed after being recorded.", c.targetID));}
+				}
+				success &= shader::execute(c.shaderID, c.dispatch, target);
+
+			} else if constexpr (std::is_same_v<T, commands::Uniform>) {
+				shared::shaders[c.shaderID].setUniform(c.name, c.value);
+
+			} else if constexpr (std::is_same_v<T, commands::MatrixUniform>) {
+				glm::mat4 value = glm::mat4(1.0f);
+				for (MatrixType type : c.matrices) {
+					value = value * matrices::getMatrix(type, c.cameraID, c.position, c.rotation, c.scale);
+				}
+				shared::shaders[c.shaderID].setUniform(c.name, value);
+
+			} else if constexpr (std::is_same_v<T, commands::Bind>) {
+				shared::shaders[c.shaderID].bindTexture(c.binding, shared::textures[c.textureID], c.access);
+
+			} else if constexpr (std::is_same_v<T, commands::Swap>) {
+				shared::texturePairs[c.pairID].swap();
+
+			} else if constexpr (std::is_same_v<T, commands::Barrier>) {
+				barriers::issue(c.bits);
+			}
+		}, command);
+	}
+	return success;
+}
+
+
+void clear(int listID) {
+	getList(listID).commands.clear();
+}
+
+
+void remove(int listID) {
+	if (IDnotInRange(listID, constants::misc::MAX_COMMAND_LISTS)) {
+		utils::cerr(std::format("Command list ID [{}] is invalid : Out of range [0 - {}]", listID, constants::misc::MAX_COMMAND_LISTS));
+	}
+
+	commands::lists[listID].destroy();
+}
+
+
+}
+
+
+
+
+
+
+
+namespace drawQueue {
+
+
+drawqueue::Queue& getQueue(int queueID) {
+	if (IDnotInRange(queueID, constants::misc::MAX_DRAW_QUEUES)) {
+		utils::cerr(std::format("Draw queue ID [{}] is invalid : Out of range [0 - {}]", queueID, constants::misc::MAX_DRAW_QUEUES));
+	}
+	drawqueue::Queue& queue = drawqueue::queues[queueID];
+	if (!queue.isValid()) {
+		utils::cerr(std::format("Draw queue ID [{}] is invalid : Was never initialised, or was destroyed.", queueID));
+	}
+	return queue;
+}
+
+
+
+int create(std::string name) {
+	if (drawqueue::numberOfQueues >= constants::misc::MAX_DRAW_QUEUES) {
+		utils::cerr(std::format(
+			"Exceeded maximum number of allowed draw queues [{} > {}]",
+			drawqueue::numberOfQueues, constants::misc::MAX_DRAW_QUEUES
+		));
+	}
+
+	GL_LOG_MINIMAL(std::format("Creating draw queue \"{}\"", name));
+	drawqueue::queues[drawqueue::numberOfQueues].create(name);
+	return drawqueue::numberOfQueues++;
+}
+
+
+//Checked & cast now, so flushing only sorts and draws.
+void submit(
+	int queueID, int shaderID, int meshID, int targetID, std::map<GLuint, int> textures,
+	py::dict uniforms, float depth, bool transparent
+) {
+	checkContextThread("queue_draw");
+	drawqueue::Queue& queue = getQueue(queueID);
+	commandList::checkShader(shaderID);
+	shader::validateRun(shaderID, targetID);
+	types::ShaderProgram& program = shared::shaders[shaderID];
+	if (meshID >= 0) {shader::validateMeshes(shaderID, {meshID});}
+	else if (program.type != ST_WORLDSPACE) {
+		utils::cerr(std::format("Shader ID [{}] isn't ST_WORLDSPACE, only worldspace shaders can be queued.", shaderID));
+	}
+
+	std::vector<std::pair<GLuint, int>> set;
+	for (const auto& [binding, textureID] : textures) {
+		if (IDnotInRange(textureID, constants::misc::MAX_TEXTURES)) {
+			utils::cerr(std::format("Texture ID [{}] is invalid : Out of range [0 - {}]", textureID, constants::misc::MAX_TEXTURES));
+		}
+		const types::Texture& tex = shared::textures[textureID];
+		if (!tex.isValid()) {
+			utils::cerr(std::format("Texture ID [{}] is invalid : Was never initialised, or was destroyed.", textureID));
+		}
+		if (!tex.sampler2D) {
+			utils::cerr(std::format("Texture ID [{}] is an image, only sampled textures can be bound per draw. Use gl.add_texture() for images.", textureID));
+		}
+		set.push_back({binding, textureID});
+	}
+
+	drawqueue::Draw draw = {shaderID, meshID, targetID, queue.internTextures(std::move(set)), {}};
+	for (const auto& [key, value] : uniforms) {
+		std::string name = py::cast<std::string>(key);
+		types::UniformValue uniform;
+		if (!castUniform(py::reinterpret_borrow<py::object>(value), uniform)) {
+			utils::cerr(std::format("Unsupported uniform type for '{}'", name));
+		}
+		GLint loc = program.uniformLocation(name);
+		if (loc != -1) {draw.uniforms.push_back({loc, uniform}); /* Like gl.add_uniform_value(), unknown names are ignored. */}
+	}
+	queue.push(std::move(draw), transparent, depth);
+}
+
+
+//Sort by key, then draw in that order, changing only what differs from the draw before.
+drawqueue::Stats flush(int queueID) {
+	PROFILE_ZONE("flush_draw_queue");
+	checkContextThread("flush_draw_queue");
+	drawqueue::Queue& queue = getQueue(queueID);
+
+	//Only things that may have changed since queueing.
+	for (const drawqueue::Draw& draw : queue.draws) {
+		if (!shared::shaders[draw.shaderID].isLinked()) {utils::cerr(std::format("Shader ID [{}] was destroyed after being queued.", draw.shaderID));}
+		if ((draw.meshID >= 0) && !shared::meshes[draw.meshID].isValid()) {utils::cerr(std::format("Mesh ID [{}] was deleted after being queued.", draw.meshID));}
+		if ((draw.targetID >= 0) && !shared::framebuffers[draw.targetID].isValid()) {utils::cerr(std::format("Framebuffer ID [{}] was destroyed after being queued.", draw.targetID));}
+	}
+	for (const auto& set : queue.textureSets) {
+		for (const auto& [binding, textureID] : set) {
+			if (!shared::textures[textureID].isValid()) {utils::cerr(std::format("Texture ID [{}] was destroyed after being queued.", textureID));}
+		}
+	}
+
+	drawqueue::Stats stats;
+	stats.draws = queue.draws.size();
+	drawqueue::Walker queued;
+	for (const drawqueue::Draw& draw : queue.draws) {queued.step(draw, stats.unsorted);}
+
+	std::vector<uint32_t> order;
+	{PROFILE_ZONE("sort_draws"); order = drawqueue::sortByKey(queue.keys);}
+
+	drawqueue::Walker walker;
+	types::ShaderProgram* program = nullptr;
+	types::Framebuffer* target = nullptr;
+	int shaderID = -1;
+	std::vector<glstate::TextureBind> samplers;
+	for (uint32_t i : order) {
+		const drawqueue::Draw& draw = queue.draws[i];
+		drawqueue::Walker::Change change = walker.step(draw, stats.made);
+
+		if (change.program && program) {barriers::afterRun(*program, shaderID);}
+		if (change.target) {
+			target = (draw.targetID >= 0) ? &(shared::framebuffers[draw.targetID]) : nullptr;
+			if (target) {
+				barriers::beforeRender(*target);
+				target->bind();
+			} else {
+				glstate::bindFramebuffer(shared::defaultFramebuffer);
+				glstate::setViewport(shared::windowResolution);
+			}
+		}
+		if (change.program) {
+			shaderID = draw.shaderID;
+			program = &(shared::shaders[shaderID]);
+			program->use();
+			program->applyTextures();
+			if (program->builtins().any()) {shader::applyBuiltins(*program, target);}
+			program->applyUniforms();
+			barriers::beforeRun(*program, shaderID);
+		}
+		if (change.restoreTextures) {program->applyTextures();}
+		if (change.textures && (draw.textureSet != 0u)) {
+			samplers.clear();
+			for (const auto& [binding, textureID] : queue.textureSets[draw.textureSet]) {
+				samplers.push_back({binding, shared::textures[textureID].GLindex});
+			}
+			glstate::bindTextureUnits(samplers.data(), samplers.size());
+		}
+		if (change.restoreUniforms) {
+			if (program->builtins().any()) {shader::applyBuiltins(*program, target);}
+			program->applyUniforms();
+		}
+		for (const auto& [loc, value] : draw.uniforms) {types::applyUniform(loc, value);}
+
+		const types::Mesh* mesh = (draw.meshID >= 0) ? &(shared::meshes[draw.meshID]) : nullptr;
+		program->run(glm::uvec3(0u), shaderID, (mesh) ? std::span<const types::Mesh* const>(&mesh, 1u) : std::span<const types::Mesh* const>());
+	}
+	if (program) {barriers::afterRun(*program, shaderID);}
+
+	GL_LOG_DEBUG(std::format(
+		"Flushed draw queue \"{}\" : [{}] draws, [{}] state switches, [{}] avoided",
+		queue.name, stats.draws, stats.made.total(), stats.avoided()
+	));
+	queue.clear();
+	return stats;
+}
+
+
+void clear(int queueID) {
+	getQueue(queueID).clear();
+}
+
+
+void remove(int queueID) {
+	if (IDnotInRange(queueID, constants::misc::MAX_DRAW_QUEUES)) {
+		utils::cerr(std::format("Draw queue ID [{}] is invalid : Out of range [0 - {}]", queueID, constants::misc::MAX_DRAW_QUEUES));
+	}
+
+	drawqueue::queues[queueID].destroy();
+}
+
+
+}
+
+
+
+
+
+
+
+namespace profile {
+
+
+void enable(bool enabled) {
+	checkContextThread("profiler_enable");
+	if (enabled && shared::init) {
+		//Line GPU timestamps up with the CPU clock, so both share one timeline.
+		GLint64 gpuNow = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+		profiler::gpuOffset = profiler::now() - static_cast<int64_t>(gpuNow);
+	}
+	GL_LOG_MINIMAL(std::format("{} CPU profiler", (enabled) ? "Enabled" : "Disabled"));
+	profiler::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+
+size_t dump(std::string filePath) {
+	size_t count = profiler::dump(filePath, [](int shaderID) {
+		if (IDnotInRange(shaderID, constants::misc::MAX_SHADERS)) {return std::string("shader");}
+		return std::format("{} [{}]", shared::shaders[shaderID].name, shaderID);
+	});
+	GL_LOG_MINIMAL(std::format("Wrote [{}] profiler events to \"{}\"", count, filePath));
+	return count;
+}
+
+
+void clear() {profiler::clear();}
+
+
+}
+
+
+
+
+
+
+
+namespace offscreen {
+
+//Offscreen stand-in for the window's framebuffer.
+GLuint FBO = 0u, colourRBO = 0u, depthRBO = 0u;
+
+#ifdef GL_MODULE_EGL
+EGLDisplay display = EGL_NO_DISPLAY;
+EGLContext context = EGL_NO_CONTEXT;
+#endif
+
+
+//Create a surfaceless EGL context. Needs no display server, works with Mesa's llvmpipe.
+bool createContext(const types::GLVersion& openGLVersion, ContextMode mode) {
+#ifdef GL_MODULE_EGL
+	//Prefer Mesa's surfaceless platform, fall back to whatever the default display is (e.g. a GPU device).
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+	auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+	if (getPlatformDisplay) {display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);}
+#endif
+	if (display == EGL_NO_DISPLAY) {display = eglGetDisplay(EGL_DEFAULT_DISPLAY);}
+	if (display == EGL_NO_DISPLAY) {return false;}
+
+	EGLint major = 0, minor = 0;
+	if (!eglInitialize(display, &major, &minor)) {return false;}
+	GL_LOG_MINIMAL(std::format("Initialised EGL [{}.{}] : {}", major, minor, eglQueryString(display, EGL_VENDOR)));
+
+	if (!eglBindAPI((openGLVersion.embedded) ? EGL_OPENGL_ES_API : EGL_OPENGL_API)) {return false;}
+
+	const EGLint configAttribs[] = {
+		EGL_RENDERABLE_TYPE, (openGLVersion.embedded) ? EGL_OPENGL_ES3_BIT : EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig config = nullptr;
+	EGLint numConfigs = 0;
+	if (!eglChooseConfig(display, configAttribs, &config, 1, &numConfigs) || (numConfigs < 1)) {return false;}
+
+	std::vector<EGLint> contextAttribs = {
+		EGL_CONTEXT_MAJOR_VERSION, static_cast<EGLint>(openGLVersion.major),
+		EGL_CONTEXT_MINOR_VERSION, static_cast<EGLint>(openGLVersion.minor),
+	};
+	if (!openGLVersion.embedded) {
+		contextAttribs.insert(contextAttribs.end(), {EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT});
+	}
+	if (mode == CM_DEBUG) {
+		contextAttribs.insert(contextAttribs.end(), {EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE});
+	}
+#ifdef EGL_CONTEXT_OPENGL_NO_ERROR_KHR
+	else {
+		const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+		if (extensions && std::strstr(extensions, "EGL_KHR_create_context_no_error")) {
+			contextAttribs.insert(contextAttribs.end(), {EGL_CONTEXT_OPENGL_NO_ERROR_KHR, EGL_TRUE});
+		}
+	}
+#endif
+	contextAttribs.push_back(EGL_NONE);
+
+	context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs.data());
+	if (context == EGL_NO_CONTEXT) {return false;}
+
+	//No surface at all; everything draws into the offscreen framebuffer.
+	return eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context) == EGL_TRUE;
+#else
+	utils::cerr("Headless mode needs the module to be built with EGL.");
+	return false;
+#endif
 }
 
 
+void destroyContext() {
+#ifdef GL_MODULE_EGL
+	if (display != EGL_NO_DISPLAY) {
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (context != EGL_NO_CONTEXT) {eglDestroyContext(display, context);}
+		eglTerminate(display);
+	}
+	display = EGL_NO_DISPLAY;
+	context = EGL_NO_CONTEXT;
+#endif
 }
 
 
+//Framebuffer with an explicit size, used wherever the window's would be.
+void createFramebuffer(glm::ivec2 resolution) {
+	glGenRenderbuffers(1, &colourRBO);
+	glBindRenderbuffer(GL_RENDERBUFFER, colourRBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, resolution.x, resolution.y);
+
+	glGenRenderbuffers(1, &depthRBO);
+	glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, resolution.x, resolution.y);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &FBO);
+	glstate::bindFramebuffer(FBO);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colourRBO);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
 
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		utils::cerr("Headless framebuffer is incomplete.");
+	}
+	shared::defaultFramebuffer = FBO;
+}
 
 
+void destroyFramebuffer() {
+	if (FBO) {glstate::forgetFramebuffer(FBO); glDeleteFramebuffers(1, &FBO);}
+	if (colourRBO) {glDeleteRenderbuffers(1, &colourRBO);}
+	if (depthRBO) {glDeleteRenderbuffers(1, &depthRBO);}
+	FBO = colourRBO = depthRBO = 0u;
+	shared::defaultFramebuffer = 0u;
+}
 
+}
 
-void init(std::string name, glm::ivec2 resolution, const types::GLVersion& openGLVersion) {
-	if (shared::window) {return; /* GLFW window already active */}
-	utils::cout(std::format(
-		"Initialising OpenGL version [{}.{}0 {}]",
-		openGLVersion.major, openGLVersion.minor, ((openGLVersion.embedded) ? "ES" : "CORE")
+
+
+void init(std::string name, glm::ivec2 resolution, const types::GLVersion& openGLVersion, bool headless, ContextMode mode) {
+	if (shared::init) {return; /* Context already active */}
+	GL_LOG_MINIMAL(std::format(
+		"Initialising OpenGL version [{}.{}0 {}] in {} mode",
+		openGLVersion.major, openGLVersion.minor, ((openGLVersion.embedded) ? "ES" : "CORE"),
+		(mode == CM_RELEASE) ? "release" : "debug"
 	));
 	if (!openGLVersion.valid()) {
 		//Version is too old. Do not allow.
@@ -761,6 +1676,38 @@ void init(std::string name, glm::ivec2 resolution, const types::GLVersion& openG
 		return;
 	}
 	shared::windowResolution = resolution;
+	shared::contextThread = std::this_thread::get_id();
+	shared::contextMode = mode;
+	shared::startTime = std::chrono::steady_clock::now();
+	shared::frameIndex = 0u;
+	gldebug::reset();
+
+
+	if (headless) {
+		if ((resolution.x < 1) || (resolution.y < 1)) {
+			utils::cerr(std::format("Headless mode needs an explicit framebuffer size, got [{}, {}]", resolution.x, resolution.y));
+		}
+		GL_LOG_MINIMAL(std::format("Creating headless context with a [{}, {}] framebuffer", resolution.x, resolution.y));
+		if (!offscreen::createContext(openGLVersion, mode)) {
+			offscreen::destroyContext();
+			utils::cerr("Failed to create headless EGL context");
+		}
+
+		//GLEW; glewInit() also loads GLX, which fails without a display. Only load the GL functions.
+		glewExperimental = GL_TRUE;
+		if (glewContextInit() != GLEW_OK) {
+			offscreen::destroyContext();
+			utils::cerr("Failed to initialize GLEW");
+		}
+
+		offscreen::createFramebuffer(resolution);
+		shared::headless = true;
+		prepareOpenGL();
+
+		shared::init = true;
+		GL_LOG_MINIMAL("Successfully loaded GL-Module [Headless]");
+		return;
+	}
 
 
 	//GLFW
@@ -772,13 +1719,21 @@ void init(std::string name, glm::ivec2 resolution, const types::GLVersion& openG
 		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 	}
 	openGLVersion.use();
+	if (mode == CM_RELEASE) {glfwWindowHint(GLFW_CONTEXT_NO_ERROR, GLFW_TRUE); /* Skips validation, errors become undefined behaviour. */}
+	else {glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);}
 	shared::window = glfwCreateWindow(resolution.x, resolution.y, name.c_str(), nullptr, nullptr);
 	if (!shared::window) {
 		//GLFW could not create window.
 		utils::cerr("Failed to create window");
 	}
 	glfwMakeContextCurrent(shared::window);
-	glfwSetKeyCallback(shared::window, glfwKeyCallback);
+	//No primary monitor on some setups (Wayland, some Xvfb/remote ones), then the refresh rate stays unknown.
+	if (GLFWmonitor* monitor = glfwGetPrimaryMonitor()) {
+		if (const GLFWvidmode* video = glfwGetVideoMode(monitor)) {pacing::refreshRate = video->refreshRate;}
+	}
+	glfwSetKeyCallback(shared::window, input::keyCallback);
+	glfwSetMouseButtonCallback(shared::window, input::mouseButtonCallback);
+	glfwSetScrollCallback(shared::window, input::scrollCallback);
 
 
 	//GLEW
@@ -795,31 +1750,52 @@ void init(std::string name, glm::ivec2 resolution, const types::GLVersion& openG
 
 
 	shared::init = true;
-	utils::cout("Successfully loaded GL-Module");
+	GL_LOG_MINIMAL("Successfully loaded GL-Module");
 }
 
 
 
 void terminate() {
 	//Told to close all active contexts and whatnot.
-	if (shared::window) {
-		glfwDestroyWindow(shared::window);
-		shared::window = nullptr;
-		glfwTerminate();
+	checkContextThread("terminate");
+	if (shared::init) {
+		//GL objects need the context, free them before it goes.
+		timing::reset();
+		for (auto& s : shared::shaders)  {s.destroy();}
+		for (auto& m : shared::meshes)   {m.destroy();}
+		for (auto& p : shared::texturePairs) {p.destroy();}
+		for (auto& f : shared::framebuffers) {f.destroy();}
+		for (auto& t : shared::textures) {t.destroy();}
+		for (auto& c : shared::cameras)  {c.destroy();}
+
+		if (shared::headless) {
+			offscreen::destroyFramebuffer();
+			offscreen::destroyContext();
+			shared::headless = false;
+		} else {
+			glfwDestroyWindow(shared::window);
+			shared::window = nullptr;
+			glfwTerminate();
+		}
 		shared::init = false;
 
 		shared::numberOfShaders = 0u;
 		shared::numberOfTextures = 0u;
 		shared::numberOfCameras = 0u;
-
-		for (auto& s : shared::shaders)  {s.destroy();}
-		for (auto& t : shared::textures) {t.destroy();}
-		for (auto& c : shared::cameras)  {c.destroy();}
-
-		utils::cout("Successfully terminated GL");
+		shared::numberOfTexturePairs = 0u;
+		shared::numberOfFramebuffers = 0u;
+		shared::numberOfMeshes = 0u;
+		commands::reset();
+		drawqueue::reset();
+		barriers::reset();
+		pacing::reset();
+		input::reset();
+
+		GL_LOG_MINIMAL("Successfully terminated GL");
 	} else {
-		utils::cout("Could not terminate: Was not initialised.");
+		GL_LOG_MINIMAL("Could not terminate: Was not initialised.");
 	}
+	logger::flush();
 }
 
 }
\ No newline at end of file
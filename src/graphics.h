@@ -4,6 +4,10 @@
 #include "includes.h"
 #include "global.h"
 #include "utils.h"
+#include "timing.h"
+#include "mesh.h"
+#include "meshopt.h"
+#include "drawqueue.h"
 
 
 //////// PY MODULE ////////
@@ -19,6 +23,7 @@ namespace graphics {
 	namespace matrices {
 
 		glm::mat4 getMatrix(MatrixType type, int cameraID, glm::vec3 position, glm::vec3 rotation, glm::vec3 scale);
+		void getModelMatrices(const float* positions, const float* rotations, const float* scales, float* out, size_t count);
 
 	}
 
@@ -35,7 +40,10 @@ namespace graphics {
 		void setFOV(int cameraID, float FOVdegrees, float FOVradians);
 		void setZclip(int cameraID, float zNear, float zFar);
 
+		const types::Camera::Matrices& getMatrices(int cameraID);
+
 		void remove(int cameraID);
+		void cull(int cameraID, const float* bounds, size_t count, size_t stride, uint8_t* visible);
 
 	}
 
@@ -45,9 +53,22 @@ namespace graphics {
 		int load(std::string filePath, std::string name);
 		void save(int textureID, std::string filePath);
 		int create(glm::ivec2 resolution, glm::vec4 fillColour, std::string name);
-		bool bind(int shaderID, int textureID, int binding);
+		bool bind(int shaderID, int textureID, int binding, ImageAccess access);
 		void remove(int textureID);
 
+		int createPair(int frontID, int backID, std::string name);
+		bool bindPair(int shaderID, int pairID, int binding, PairSide side, ImageAccess access);
+		void swapPair(int pairID);
+		void removePair(int pairID);
+
+	}
+
+	namespace framebuffer {
+
+		int create(std::vector<int> textureIDs, bool depth, std::string name);
+		void clear(int framebufferID, glm::vec4 colour, float depth);
+		void remove(int framebufferID);
+
 	}
 
 	namespace shader {
@@ -55,13 +76,76 @@ namespace graphics {
 		int load(ShaderType type, std::string vertex, std::string fragment, std::string compute);
 		void configure(ShaderType type, bool cull);
 		bool addUniformValue(int shaderID, std::string uniformName, pybind11::object value);
-		bool addVAO(int shaderID, VAOFormat format, std::vector<float> values, std::vector<int> indicesSigned);
-		bool run(int shaderID, glm::uvec3 dispatchSize);
+		bool addVAO(int shaderID, VAOFormat format, std::vector<float> values, std::vector<GLuint> indices, bool optimize, VertexPacking packing);
+		bool addVAOLayout(int shaderID, const std::vector<vertexpack::AttributeFormat>& attributes, const std::vector<vertexpack::VertexStream>& streams, std::vector<GLuint> indices);
+		mesh::Info loadMesh(int shaderID, std::string filePath, bool optimize, VertexPacking packing);
+		bool run(int shaderID, glm::uvec3 dispatchSize, int targetID, int meshID);
+		bool draw(int shaderID, std::vector<int> meshIDs, int targetID);
+		types::Framebuffer* validateRun(int shaderID, int targetID);
+		std::vector<const types::Mesh*> validateMeshes(int shaderID, const std::vector<int>& meshIDs);
+		bool execute(int shaderID, glm::uvec3 dispatchSize, types::Framebuffer* target, std::span<const types::Mesh* const> meshes = {});
+		void setBarrierMode(BarrierMode mode);
+		uint64_t barrierCount();
+		void enableGPUTiming(bool enabled);
+		std::map<int, timing::GPUStats> getGPUTimings();
+
+	}
+
+
+	namespace geometry {
+
+		int create(VAOFormat format, std::vector<float> vertices, std::vector<GLuint> indices, bool optimize, VertexPacking packing, std::string name);
+		int createLayout(const std::vector<vertexpack::AttributeFormat>& attributes, const std::vector<vertexpack::VertexStream>& streams, std::vector<GLuint> indices, std::string name);
+		void remove(int meshID);
+
+	}
+
+
+	namespace commandList {
+
+		int create(std::string name);
+		void recordConfigure(int listID, ShaderType type, bool cull);
+		void recordRun(int listID, int shaderID, glm::uvec3 dispatchSize, int targetID);
+		void recordUniform(int listID, int shaderID, std::string uniformName, pybind11::object value);
+		void recordMatrixUniform(
+			int listID, int shaderID, std::string uniformName, std::vector<MatrixType> matrices,
+			int cameraID, glm::vec3 position, glm::vec3 rotation, glm::vec3 scale
+		);
+		void recordBind(int listID, int shaderID, int textureID, int binding, ImageAccess access);
+		void recordSwap(int listID, int pairID);
+		void recordBarrier(int listID);
+		bool submit(int listID);
+		void clear(int listID);
+		void remove(int listID);
+
+	}
+
+
+	namespace drawQueue {
+
+		int create(std::string name);
+		void submit(
+			int queueID, int shaderID, int meshID, int targetID, std::map<GLuint, int> textures,
+			pybind11::dict uniforms, float depth, bool transparent
+		);
+		drawqueue::Stats flush(int queueID);
+		void clear(int queueID);
+		void remove(int queueID);
+
+	}
+
+
+	namespace profile {
+
+		void enable(bool enabled);
+		size_t dump(std::string filePath);
+		void clear();
 
 	}
 
 
-	void init(std::string name, glm::ivec2 resolution, const types::GLVersion& version);
+	void checkContextThread(const char* caller);
+	void init(std::string name, glm::ivec2 resolution, const types::GLVersion& version, bool headless, ContextMode mode);
 	void terminate();
 
 }
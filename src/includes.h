@@ -27,6 +27,7 @@
 #include <iostream>
 #include <regex>
 #include <set>
+#include <span>
 #include <sstream>
 #include <format>
 #include <variant>
@@ -38,6 +39,7 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/packing.hpp>
 #include <glm/gtx/transform.hpp>
 //////// GLM HEADERS ////////
 
@@ -56,6 +58,15 @@
 
 
 
+//////// EGL HEADERS ////////
+#ifdef GL_MODULE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+//////// EGL HEADERS ////////
+
+
+
 
 
 #endif
@@ -0,0 +1,180 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+
+#include <atomic>
+#include <bitset>
+
+
+
+//Keyboard/mouse input.
+//Key state is kept as bitsets over every GLFW key code. The callbacks latch press/release edges between
+//polls, so a tap shorter than a frame still shows up as both pressed and released.
+//Every key, mouse button and scroll event is also pushed to a lock-free ring with its timestamp, which
+//Python drains in one gl.drain_events() call.
+namespace input {
+
+
+constexpr size_t KEY_COUNT = GLFW_KEY_LAST + 1;
+
+inline std::bitset<KEY_COUNT> held;     //Live, updated by the callback.
+inline std::bitset<KEY_COUNT> pressed;  //Went down since the last poll.
+inline std::bitset<KEY_COUNT> released; //Went up since the last poll.
+
+
+constexpr size_t BUTTON_COUNT = GLFW_MOUSE_BUTTON_LAST + 1;
+
+inline std::bitset<BUTTON_COUNT> buttonsHeld;
+inline std::bitset<BUTTON_COUNT> buttonsPressed;
+inline std::bitset<BUTTON_COUNT> buttonsReleased;
+
+inline glm::dvec2 scrolled = glm::dvec2(0.0); //Summed since the last poll.
+
+
+inline bool validKey(int key) {return (key >= 0) && (key < static_cast<int>(KEY_COUNT));}
+
+
+
+//Flat copy of the whole input state, refreshed in place by gl.poll_events().
+//gl.input_snapshot() hands out NumPy views straight onto this, so reading input allocates nothing.
+struct Snapshot {
+	std::array<bool, KEY_COUNT> held = {};
+	std::array<bool, KEY_COUNT> pressed = {};
+	std::array<bool, KEY_COUNT> released = {};
+	std::array<bool, BUTTON_COUNT> buttonsHeld = {};
+	std::array<bool, BUTTON_COUNT> buttonsPressed = {};
+	std::array<bool, BUTTON_COUNT> buttonsReleased = {};
+	std::array<double, 2> cursor = {};
+	std::array<double, 2> cursorDelta = {};
+	std::array<double, 2> scroll = {};
+};
+
+inline Snapshot snapshot;
+
+
+
+//One input event, as given by GLFW.
+struct Event {
+	double time = 0.0; //[s] glfwGetTime()
+	InputEventType type = IE_KEY;
+	int code = 0; //Key, or mouse button.
+	int action = 0; //GLFW_PRESS/GLFW_RELEASE/GLFW_REPEAT, 0 for scroll.
+	int mods = 0;
+	double x = 0.0, y = 0.0; //Cursor position for mouse buttons, offset for scroll.
+};
+
+
+//Single-producer (GLFW callbacks) / single-consumer (gl.drain_events()) ring.
+//When full, new events are dropped and counted rather than blocking the callback.
+class EventRing {
+private:
+	static constexpr size_t SIZE = constants::misc::INPUT_RING;
+	static_assert((SIZE & (SIZE - 1u)) == 0u, "Input ring size must be a power of 2");
+
+	std::array<Event, SIZE> _events = {};
+	std::atomic<uint64_t> _head = 0u; //Written by the producer
+	std::atomic<uint64_t> _tail = 0u; //Written by the consumer
+	std::atomic<uint64_t> _dropped = 0u;
+
+public:
+	bool push(const Event& e) {
+		uint64_t head = _head.load(std::memory_order_relaxed);
+		if ((head - _tail.load(std::memory_order_acquire)) >= SIZE) {
+			_dropped.fetch_add(1u, std::memory_order_relaxed);
+			return false;
+		}
+		_events[head & (SIZE - 1u)] = e;
+		_head.store(head + 1u, std::memory_order_release);
+		return true;
+	}
+
+	//Pass every queued event to func, oldest first. Returns how many there were.
+	template<typename Func>
+	size_t drain(Func&& func) {
+		uint64_t tail = _tail.load(std::memory_order_relaxed);
+		uint64_t head = _head.load(std::memory_order_acquire);
+		for (uint64_t i=tail; i<head; i++) {func(_events[i & (SIZE - 1u)]);}
+		_tail.store(head, std::memory_order_release);
+		return static_cast<size_t>(head - tail);
+	}
+
+	//Events lost to a full ring since last asked.
+	uint64_t takeDropped() {return _dropped.exchange(0u, std::memory_order_relaxed);}
+
+	void clear() {
+		_tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+		_dropped.store(0u, std::memory_order_relaxed);
+	}
+};
+
+inline EventRing events;
+
+
+
+//Start of gl.poll_events(), before GLFW runs the callbacks.
+inline void beginPoll() {
+	pressed.reset();
+	released.reset();
+	buttonsPressed.reset();
+	buttonsReleased.reset();
+	scrolled = glm::dvec2(0.0);
+}
+
+
+//End of gl.poll_events(), once the callbacks and cursor are up to date.
+inline void refreshSnapshot(glm::dvec2 cursor, glm::dvec2 cursorDelta) {
+	for (size_t k=0; k<KEY_COUNT; k++) {
+		snapshot.held[k] = held[k];
+		snapshot.pressed[k] = pressed[k];
+		snapshot.released[k] = released[k];
+	}
+	for (size_t b=0; b<BUTTON_COUNT; b++) {
+		snapshot.buttonsHeld[b] = buttonsHeld[b];
+		snapshot.buttonsPressed[b] = buttonsPressed[b];
+		snapshot.buttonsReleased[b] = buttonsReleased[b];
+	}
+	snapshot.cursor = {cursor.x, cursor.y};
+	snapshot.cursorDelta = {cursorDelta.x, cursorDelta.y};
+	snapshot.scroll = {scrolled.x, scrolled.y};
+}
+
+
+//GLFW callbacks.
+inline void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+	events.push(Event{glfwGetTime(), IE_KEY, key, action, mods, 0.0, 0.0});
+	if (!validKey(key)) {return; /* GLFW_KEY_UNKNOWN */}
+
+	if (action == GLFW_PRESS) {held.set(key); pressed.set(key);}
+	else if (action == GLFW_RELEASE) {held.reset(key); released.set(key);}
+}
+
+inline void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+	double x = 0.0, y = 0.0;
+	glfwGetCursorPos(window, &x, &y);
+	events.push(Event{glfwGetTime(), IE_MOUSE_BUTTON, button, action, mods, x, y});
+	if ((button < 0) || (button >= static_cast<int>(BUTTON_COUNT))) {return;}
+
+	if (action == GLFW_PRESS) {buttonsHeld.set(button); buttonsPressed.set(button);}
+	else if (action == GLFW_RELEASE) {buttonsHeld.reset(button); buttonsReleased.set(button);}
+}
+
+inline void scrollCallback(GLFWwindow* window, double xOffset, double yOffset) {
+	events.push(Event{glfwGetTime(), IE_SCROLL, 0, 0, 0, xOffset, yOffset});
+	scrolled += glm::dvec2(xOffset, yOffset);
+}
+
+
+inline void reset() {
+	held.reset();
+	pressed.reset();
+	released.reset();
+	buttonsHeld.reset();
+	buttonsPressed.reset();
+	buttonsReleased.reset();
+	scrolled = glm::dvec2(0.0);
+	snapshot = Snapshot();
+	events.clear();
+}
+
+
+}
@@ -0,0 +1,223 @@
+#pragma once
+#include "includes.h"
+#include "utils.h"
+
+#include <charconv>
+#include <string_view>
+
+
+
+//Minimal JSON reader, enough for glTF's JSON chunk.
+//Parses the whole document into a tree up front; errors throw through utils::cerr() with the byte offset.
+namespace json {
+
+
+struct Value {
+	enum Kind {NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT};
+
+	Kind kind = NUL;
+	bool boolean = false;
+	double number = 0.0;
+	std::string string;
+	std::vector<Value> array;
+	std::vector<std::pair<std::string, Value>> object; //In document order.
+
+
+	bool isObject() const {return kind == OBJECT;}
+	bool isArray() const {return kind == ARRAY;}
+	size_t size() const {return (kind == ARRAY) ? array.size() : object.size();}
+
+	//Member of an object, nullptr if missing (or not an object).
+	const Value* find(std::string_view key) const {
+		if (kind != OBJECT) {return nullptr;}
+		for (const auto& [k, v] : object) {if (k == key) {return &v;}}
+		return nullptr;
+	}
+
+	//Element of an array, nullptr if out of range (or not an array).
+	const Value* at(size_t i) const {
+		return ((kind == ARRAY) && (i < array.size())) ? &(array[i]) : nullptr;
+	}
+
+	//Numeric member, or fallback if missing.
+	double numberOr(std::string_view key, double fallback) const {
+		const Value* v = find(key);
+		return (v && (v->kind == NUMBER)) ? v->number : fallback;
+	}
+
+	//String member, or fallback if missing.
+	std::string_view stringOr(std::string_view key, std::string_view fallback) const {
+		const Value* v = find(key);
+		return (v && (v->kind == STRING)) ? std::string_view(v->string) : fallback;
+	}
+};
+
+
+
+class Parser {
+private:
+	std::string_view _text;
+	size_t _pos = 0u;
+	size_t _depth = 0u;
+
+	static constexpr size_t MAX_DEPTH = 256u; //Nothing sane nests this deep, stops a hostile file overflowing the stack.
+
+
+	[[noreturn]] void _fail(std::string_view what) const {
+		utils::cerr(std::format("JSON parse error at byte [{}]: {}", _pos, what));
+		std::abort(); //Unreachable, utils::cerr() throws.
+	}
+
+	void _skipSpace() {
+		while ((_pos < _text.size()) && ((_text[_pos] == ' ') || (_text[_pos] == '\t') || (_text[_pos] == '\n') || (_text[_pos] == '\r'))) {_pos++;}
+	}
+
+	char _peek() {
+		_skipSpace();
+		return (_pos < _text.size()) ? _text[_pos] : '\0';
+	}
+
+	void _expect(char c) {
+		if (_peek() != c) {_fail(std::format("expected '{}'", c));}
+		_pos++;
+	}
+
+	bool _literal(std::string_view word) {
+		if (_text.substr(_pos, word.size()) != word) {return false;}
+		_pos += word.size();
+		return true;
+	}
+
+
+	static void _appendUTF8(std::string& out, uint32_t code) {
+		if (code < 0x80u) {out += static_cast<char>(code);}
+		else if (code < 0x800u) {
+			out += static_cast<char>(0xC0u | (code >> 6));
+			out += static_cast<char>(0x80u | (code & 0x3Fu));
+		} else if (code < 0x10000u) {
+			out += static_cast<char>(0xE0u | (code >> 12));
+			out += static_cast<char>(0x80u | ((code >> 6) & 0x3Fu));
+			out += static_cast<char>(0x80u | (code & 0x3Fu));
+		} else {
+			out += static_cast<char>(0xF0u | (code >> 18));
+			out += static_cast<char>(0x80u | ((code >> 12) & 0x3Fu));
+			out += static_cast<char>(0x80u | ((code >> 6) & 0x3Fu));
+			out += static_cast<char>(0x80u | (code & 0x3Fu));
+		}
+	}
+
+	uint32_t _hex4() {
+		if (_pos + 4u > _text.size()) {_fail("truncated \\u escape");}
+		uint32_t code = 0u;
+		auto [end, ec] = std::from_chars(_text.data() + _pos, _text.data() + _pos + 4u, code, 16);
+		if ((ec != std::errc()) || (end != _text.data() + _pos + 4u)) {_fail("bad \\u escape");}
+		_pos += 4u;
+		return code;
+	}
+
+	std::string _string() {
+		_expect('"');
+		std::string out;
+		while (true) {
+			if (_pos >= _text.size()) {_fail("unterminated string");}
+			char c = _text[_pos++];
+			if (c == '"') {break;}
+			if (c != '\\') {out += c; continue;}
+
+			if (_pos >= _text.size()) {_fail("unterminated escape");}
+			switch (_text[_pos++]) {
+				case '"':  {out += '"'; break;}
+				case '\\': {out += '\\'; break;}
+				case '/':  {out += '/'; break;}
+				case 'b':  {out += '\b'; break;}
+				case 'f':  {out += '\f'; break;}
+				case 'n':  {out += '\n'; break;}
+				case 'r':  {out += '\r'; break;}
+				case 't':  {out += '\t'; break;}
+				case 'u': {
+					uint32_t code = _hex4();
+					//Surrogate pair.
+					if ((code >= 0xD800u) && (code < 0xDC00u) && _literal("\\u")) {
+						uint32_t low = _hex4();
+						code = 0x10000u + ((code - 0xD800u) << 10) + (low - 0xDC00u);
+					}
+					_appendUTF8(out, code);
+					break;
+				}
+				default: {_fail("unknown escape");}
+			}
+		}
+		return out;
+	}
+
+	double _number() {
+		size_t start = _pos;
+		if ((_pos < _text.size()) && (_text[_pos] == '-')) {_pos++;}
+		while ((_pos < _text.size()) && std::strchr("0123456789.eE+-", _text[_pos]) && (_text[_pos] != '\0')) {_pos++;}
+
+		double out = 0.0;
+		auto [end, ec] = std::from_chars(_text.data() + start, _text.data() + _pos, out);
+		if ((ec != std::errc()) || (end != _text.data() + _pos)) {_pos = start; _fail("bad number");}
+		return out;
+	}
+
+
+	Value _value() {
+		if (++_depth > MAX_DEPTH) {_fail("nested too deeply");}
+		Value out;
+
+		switch (_peek()) {
+			case '{': {
+				out.kind = Value::OBJECT;
+				_pos++;
+				if (_peek() == '}') {_pos++; break;}
+				while (true) {
+					std::string key = _string();
+					_expect(':');
+					out.object.emplace_back(std::move(key), _value());
+					if (_peek() == ',') {_pos++; continue;}
+					_expect('}');
+					break;
+				}
+				break;
+			}
+			case '[': {
+				out.kind = Value::ARRAY;
+				_pos++;
+				if (_peek() == ']') {_pos++; break;}
+				while (true) {
+					out.array.push_back(_value());
+					if (_peek() == ',') {_pos++; continue;}
+					_expect(']');
+					break;
+				}
+				break;
+			}
+			case '"': {out.kind = Value::STRING; out.string = _string(); break;}
+			case 't': {if (!_literal("true"))  {_fail("bad literal");} out.kind = Value::BOOLEAN; out.boolean = true; break;}
+			case 'f': {if (!_literal("false")) {_fail("bad literal");} out.kind = Value::BOOLEAN; break;}
+			case 'n': {if (!_literal("null"))  {_fail("bad literal");} break;}
+			case '\0': {_fail("unexpected end of document");}
+			default: {out.kind = Value::NUMBER; out.number = _number(); break;}
+		}
+
+		_depth--;
+		return out;
+	}
+
+public:
+	explicit Parser(std::string_view text) : _text(text) {}
+
+	Value parse() {
+		_pos = 0u; _depth = 0u;
+		Value root = _value();
+		if (_peek() != '\0') {_fail("trailing characters after document");}
+		return root;
+	}
+};
+
+
+inline Value parse(std::string_view text) {return Parser(text).parse();}
+
+
+}
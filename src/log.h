@@ -0,0 +1,215 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+#include "utils.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+
+
+//////// PY MODULE ////////
+#include <pybind11/pybind11.h>
+//////// PY MODULE ////////
+
+
+
+//Logging.
+//GL_LOG() only evaluates its arguments when the level is both compiled in and allowed by gl.set_output(), so a
+//disabled message costs one branch. Enabled messages are formatted on the calling thread and queued on a ring;
+//a background thread writes them out to the chosen sink, so console/file/Python IO never stalls the render loop.
+//Define GL_LOG_LEVEL (0 = V_SILENT, 1 = V_MINIMAL, 2 = V_DEBUG) to compile out anything more verbose.
+namespace logger {
+
+namespace py = pybind11;
+
+
+struct Message {
+	Verbosity level = V_MINIMAL;
+	std::string text;
+};
+
+
+//Ring and worker state, all guarded by mutex.
+inline std::mutex mutex;
+inline std::condition_variable wake;    //Worker waits for messages.
+inline std::condition_variable drained; //flush() waits for the worker.
+
+inline std::array<Message, constants::misc::LOG_RING> ring;
+inline uint64_t head = 0u;
+inline uint64_t tail = 0u;
+inline uint64_t dropped = 0u;
+inline bool writing = false; //Worker has a batch out of the ring but not yet written.
+inline bool stopping = false;
+inline std::thread worker;
+
+//Sink, only changed while the worker is stopped.
+inline LogSink sink = LS_STDOUT;
+inline std::ofstream file;
+inline py::object* pyLogger = nullptr; //logging.getLogger("gl"), only touched with the GIL held.
+
+
+inline bool enabled(Verbosity level) {return verbosityAllowed(level);}
+
+
+//Python's logging levels.
+inline int pythonLevel(Verbosity level) {return (level == V_DEBUG) ? 10 /* DEBUG */ : 20 /* INFO */;}
+
+
+inline void emit(std::vector<Message>& batch, uint64_t lost) {
+	if (lost > 0u) {
+		batch.push_back(Message{V_MINIMAL, std::format("Log ring was full, dropped [{}] messages.", lost)});
+	}
+
+	switch (sink) {
+		case LS_STDOUT: {
+			for (const Message& m : batch) {std::cout << "[C++] " << m.text << '\n';}
+			std::cout << std::flush;
+			break;
+		}
+		case LS_FILE: {
+			for (const Message& m : batch) {file << m.text << '\n';}
+			file << std::flush;
+			break;
+		}
+		case LS_PYTHON: {
+			py::gil_scoped_acquire gil;
+			if (!pyLogger) {break;}
+			try {
+				for (const Message& m : batch) {pyLogger->attr("log")(pythonLevel(m.level), m.text);}
+			} catch (py::error_already_set& e) {
+				e.discard_as_unraisable("gl logging sink"); //Can't throw on this thread.
+			}
+			break;
+		}
+	}
+}
+
+
+inline void workerLoop() {
+	std::vector<Message> batch;
+	while (true) {
+		uint64_t lost = 0u;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [] {return stopping || (head != tail);});
+			if ((head == tail) && stopping) {break;}
+
+			batch.clear();
+			for (; tail != head; tail++) {batch.push_back(std::move(ring[tail % ring.size()]));}
+			lost = std::exchange(dropped, 0u);
+			writing = true;
+		}
+
+		emit(batch, lost);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			writing = false;
+		}
+		drained.notify_all();
+	}
+}
+
+
+//Queue one message. Drops it (and counts it) rather than block when the ring is full.
+template<typename... Args>
+inline void write(Verbosity level, Args&&... args) {
+	std::ostringstream oss;
+	((oss << args << " "), ...);
+	std::string text = oss.str();
+	if (!text.empty()) {text.pop_back(); /* Trailing separator */}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if ((head - tail) >= ring.size()) {dropped++; return;}
+		ring[head % ring.size()] = Message{level, std::move(text)};
+		head++;
+		if (!worker.joinable()) {worker = std::thread(workerLoop);}
+	}
+	wake.notify_one();
+}
+
+
+//The Python sink needs the GIL on the worker, so never block on the worker while holding it.
+template<typename Func>
+inline void withoutGIL(Func&& func) {
+	if (Py_IsInitialized() && PyGILState_Check()) {
+		py::gil_scoped_release release;
+		func();
+	} else {
+		func();
+	}
+}
+
+
+//Block until everything queued so far has been written.
+inline void flush() {
+	withoutGIL([] {
+		std::unique_lock<std::mutex> lock(mutex);
+		if (!worker.joinable()) {return;}
+		drained.wait(lock, [] {return (head == tail) && !writing;});
+	});
+}
+
+
+//Write out what's queued, then stop the worker. It restarts on the next message.
+inline void stop() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	withoutGIL([] {if (worker.joinable()) {worker.join();}});
+
+	std::lock_guard<std::mutex> lock(mutex);
+	stopping = false;
+}
+
+
+//Needs the GIL (for LS_PYTHON).
+inline void setSink(LogSink newSink, const std::string& filePath) {
+	stop();
+
+	if (file.is_open()) {file.close();}
+	if (pyLogger) {delete pyLogger; pyLogger = nullptr;}
+
+	if (newSink == LS_FILE) {
+		file.open(filePath, std::ios::out | std::ios::app);
+		if (!file.is_open()) {
+			sink = LS_STDOUT;
+			utils::cerr(std::format("Could not open log file: {}", filePath));
+		}
+	}
+	else if (newSink == LS_PYTHON) {
+		pyLogger = new py::object(py::module_::import("logging").attr("getLogger")("gl"));
+	}
+	sink = newSink;
+}
+
+
+//Interpreter exit: the worker must be gone before Python is, and the logger released while it still exists.
+inline void shutdown() {
+	stop();
+	if (file.is_open()) {file.close();}
+	if (pyLogger) {delete pyLogger; pyLogger = nullptr;}
+	sink = LS_STDOUT;
+}
+
+
+}
+
+
+
+#ifndef GL_LOG_LEVEL
+	#define GL_LOG_LEVEL 2
+#endif
+
+#define GL_LOG(level, ...) do { \
+	if constexpr (static_cast<int>(level) <= GL_LOG_LEVEL) { \
+		if (logger::enabled(level)) {logger::write(level, __VA_ARGS__);} \
+	} \
+} while (0)
+
+#define GL_LOG_MINIMAL(...) GL_LOG(V_MINIMAL, __VA_ARGS__)
+#define GL_LOG_DEBUG(...) GL_LOG(V_DEBUG, __VA_ARGS__)
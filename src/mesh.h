@@ -0,0 +1,637 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+#include "utils.h"
+#include "log.h"
+#include "json.h"
+#include "simd.h"
+
+#include <charconv>
+#include <limits>
+#include <string_view>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+
+
+//Mesh loading.
+//OBJ and binary glTF (.glb) files are memory-mapped and parsed straight into one interleaved vertex buffer and
+//a triangle index buffer, laid out as the matching VAOFormat, ready for ShaderProgram::setVAO().
+//OBJ text is split at line boundaries and parsed on several threads, then identical position/uv/normal
+//corners are merged into one vertex. Nothing here touches GL or Python, so it can run without the GIL.
+namespace mesh {
+
+
+//What gl.load_mesh() reports back.
+struct Info {
+	VAOFormat format = VAO_EMPTY;
+	size_t vertices = 0u;
+	size_t indices = 0u;
+	glm::vec3 boundsMin = glm::vec3(0.0f);
+	glm::vec3 boundsMax = glm::vec3(0.0f);
+	float acmrBefore = 0.0f; //See meshopt::Stats, equal unless optimised.
+	float acmrAfter = 0.0f;
+};
+
+
+struct Mesh {
+	VAOFormat format = VAO_EMPTY;
+	std::vector<float> vertices; //Interleaved, as constants::display::layouts.at(format).
+	std::vector<GLuint> indices; //Triangle list.
+	glm::vec3 boundsMin = glm::vec3(0.0f);
+	glm::vec3 boundsMax = glm::vec3(0.0f);
+
+	size_t stride() const {return constants::display::vertexFormatSizeMap.at(format);}
+	size_t vertexCount() const {return (format == VAO_EMPTY) ? 0u : (vertices.size() / stride());}
+
+	void computeBounds() {
+		size_t s = stride(), count = vertexCount();
+		if (count == 0u) {boundsMin = boundsMax = glm::vec3(0.0f); return;}
+
+		boundsMin = glm::vec3(std::numeric_limits<float>::max());
+		boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+		for (size_t i=0; i<count; i++) {
+			glm::vec3 p = glm::make_vec3(vertices.data() + i*s); //Position is always first.
+			boundsMin = glm::min(boundsMin, p);
+			boundsMax = glm::max(boundsMax, p);
+		}
+	}
+
+	Info info() const {return Info{format, vertexCount(), indices.size(), boundsMin, boundsMax, 0.0f, 0.0f};}
+};
+
+
+inline VAOFormat formatFor(bool uv, bool normal) {
+	if (uv && normal) {return VAO_POS_UV2D_NORMAL;}
+	if (uv) {return VAO_POS_UV2D;}
+	if (normal) {return VAO_POS_NORMAL;}
+	return VAO_POS_ONLY;
+}
+
+
+
+//Read-only view of a whole file, mapped rather than read so parsing starts without copying it first.
+class MappedFile {
+private:
+	const char* _data = nullptr;
+	size_t _size = 0u;
+#ifdef _WIN32
+	HANDLE _file = INVALID_HANDLE_VALUE;
+	HANDLE _mapping = nullptr;
+#else
+	int _fd = -1;
+#endif
+
+	void _close() {
+#ifdef _WIN32
+		if (_data) {UnmapViewOfFile(_data);}
+		if (_mapping) {CloseHandle(_mapping);}
+		if (_file != INVALID_HANDLE_VALUE) {CloseHandle(_file);}
+		_mapping = nullptr; _file = INVALID_HANDLE_VALUE;
+#else
+		if (_data) {munmap(const_cast<char*>(_data), _size);}
+		if (_fd != -1) {::close(_fd);}
+		_fd = -1;
+#endif
+		_data = nullptr; _size = 0u;
+	}
+
+public:
+	explicit MappedFile(const std::string& filePath) {
+#ifdef _WIN32
+		_file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (_file == INVALID_HANDLE_VALUE) {utils::cerr(std::format("Could not open file: {}", filePath));}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(_file, &size)) {_close(); utils::cerr(std::format("Could not read size of file: {}", filePath));}
+		_size = static_cast<size_t>(size.QuadPart);
+		if (_size == 0u) {return; /* Can't map nothing. */}
+
+		_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (_mapping) {_data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));}
+		if (!_data) {_close(); utils::cerr(std::format("Could not map file: {}", filePath));}
+#else
+		_fd = ::open(filePath.c_str(), O_RDONLY);
+		if (_fd == -1) {utils::cerr(std::format("Could not open file: {}", filePath));}
+		struct stat info;
+		if (fstat(_fd, &info) != 0) {_close(); utils::cerr(std::format("Could not read size of file: {}", filePath));}
+		_size = static_cast<size_t>(info.st_size);
+		if (_size == 0u) {return; /* Can't map nothing. */}
+
+		void* mapped = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+		if (mapped == MAP_FAILED) {_size = 0u; _close(); utils::cerr(std::format("Could not map file: {}", filePath));}
+		_data = static_cast<const char*>(mapped);
+		madvise(mapped, _size, MADV_SEQUENTIAL);
+#endif
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile() {_close();}
+
+	std::string_view view() const {return std::string_view(_data, _size);}
+};
+
+
+
+namespace obj {
+
+
+//One face corner's indices. Absolute ones are stored as written (1-based, 0 = not given), relative ones
+//(negative in the file) already offset by what the chunk had seen, still to be offset by earlier chunks.
+struct Corner {
+	int64_t index[3] = {0, 0, 0}; //Position, uv, normal
+	uint8_t relative = 0u;        //Bit per attribute
+};
+
+
+//Everything one thread parsed from its share of the lines, in file order.
+struct Chunk {
+	std::string_view text;
+	std::vector<float> positions; //xyz
+	std::vector<float> uvs;       //uv, a w is ignored
+	std::vector<float> normals;   //xyz
+	std::vector<Corner> corners;
+	std::vector<uint32_t> faces;  //Corners in each face
+	size_t skippedFaces = 0u;     //Fewer than 3 corners
+	std::string error;            //Can't throw off the calling thread, raised once all chunks are done.
+};
+
+
+inline bool isBlank(char c) {return (c == ' ') || (c == '\t') || (c == '\r');}
+
+inline void skipBlank(const char*& p, const char* end) {while ((p < end) && isBlank(*p)) {p++;}}
+
+
+inline bool readFloat(const char*& p, const char* end, float& out) {
+	skipBlank(p, end);
+	if ((p < end) && (*p == '+')) {p++; /* from_chars doesn't take a leading + */}
+	auto [next, ec] = std::from_chars(p, end, out);
+	if (ec != std::errc()) {return false;}
+	p = next;
+	return true;
+}
+
+inline bool readInt(const char*& p, const char* end, int64_t& out) {
+	auto [next, ec] = std::from_chars(p, end, out);
+	if (ec != std::errc()) {return false;}
+	p = next;
+	return true;
+}
+
+
+//Stores one attribute index of a corner. count = how many of that attribute the chunk has so far.
+inline void setIndex(Corner& corner, size_t attribute, int64_t value, size_t count) {
+	if (value < 0) {
+		corner.index[attribute] = static_cast<int64_t>(count) + value; //May go below 0 = into an earlier chunk.
+		corner.relative |= static_cast<uint8_t>(1u << attribute);
+	} else {
+		corner.index[attribute] = value;
+	}
+}
+
+
+inline void parseLine(const char* p, const char* end, Chunk& chunk) {
+	skipBlank(p, end);
+	if ((end - p) < 2) {return;}
+
+	auto floats = [&](std::vector<float>& into, size_t wanted, size_t required) {
+		const char* lineStart = p;
+		for (size_t i=0; i<wanted; i++) {
+			float value = 0.0f;
+			if (!readFloat(p, end, value)) {
+				if (i < required) {chunk.error = std::format("Bad number in line \"{}\"", std::string_view(lineStart, end));}
+				into.push_back(0.0f);
+				continue;
+			}
+			into.push_back(value);
+		}
+	};
+
+	if ((p[0] == 'v') && isBlank(p[1])) {p += 2; floats(chunk.positions, 3u, 3u); return;}
+	if ((end - p) < 3) {return;}
+	if ((p[0] == 'v') && (p[1] == 't') && isBlank(p[2])) {p += 3; floats(chunk.uvs, 2u, 1u); return;}
+	if ((p[0] == 'v') && (p[1] == 'n') && isBlank(p[2])) {p += 3; floats(chunk.normals, 3u, 3u); return;}
+	if (!((p[0] == 'f') && isBlank(p[1]))) {return; /* Groups, materials, comments, smoothing... */}
+	p += 2;
+
+	const char* lineStart = p;
+	uint32_t corners = 0u;
+	while (true) {
+		skipBlank(p, end);
+		if ((p >= end) || (*p == '#')) {break;}
+
+		Corner corner;
+		int64_t value = 0;
+		if (!readInt(p, end, value) || (value == 0)) {
+			chunk.error = std::format("Bad face in line \"{}\"", std::string_view(lineStart, end));
+			return;
+		}
+		setIndex(corner, 0u, value, chunk.positions.size() / 3u);
+
+		if ((p < end) && (*p == '/')) {
+			p++;
+			if ((p < end) && (*p != '/') && readInt(p, end, value)) {setIndex(corner, 1u, value, chunk.uvs.size() / 2u);}
+			if ((p < end) && (*p == '/')) {
+				p++;
+				if (readInt(p, end, value)) {setIndex(corner, 2u, value, chunk.normals.size() / 3u);}
+			}
+		}
+		while ((p < end) && !isBlank(*p)) {p++; /* Anything left of a malformed token. */}
+
+		chunk.corners.push_back(corner);
+		corners++;
+	}
+
+	if (corners < 3u) {
+		chunk.corners.resize(chunk.corners.size() - corners);
+		chunk.skippedFaces++;
+		return;
+	}
+	chunk.faces.push_back(corners);
+}
+
+
+inline void parseChunk(Chunk& chunk) {
+	const char* p = chunk.text.data();
+	const char* end = p + chunk.text.size();
+	while ((p < end) && chunk.error.empty()) {
+		const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+		if (!lineEnd) {lineEnd = end;}
+		parseLine(p, lineEnd, chunk);
+		p = lineEnd + 1;
+	}
+}
+
+
+//Open-addressed map of (position, uv, normal) → vertex index, sized once for the worst case (every corner unique).
+class CornerMap {
+private:
+	static constexpr uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> _slots;
+	std::vector<std::array<uint32_t, 3>> _keys; //Per vertex
+	size_t _mask = 0u;
+
+	static size_t _hash(const std::array<uint32_t, 3>& key) {
+		uint64_t h = (static_cast<uint64_t>(key[0]) * 0x9E3779B97F4A7C15ull) ^ (static_cast<uint64_t>(key[1]) * 0xC2B2AE3D27D4EB4Full) ^ (static_cast<uint64_t>(key[2]) * 0x165667B19E3779F9ull);
+		return static_cast<size_t>(h ^ (h >> 29));
+	}
+
+public:
+	explicit CornerMap(size_t corners) {
+		size_t size = 16u;
+		while (size < corners * 2u) {size <<= 1;}
+		_slots.assign(size, EMPTY);
+		_mask = size - 1u;
+		_keys.reserve(corners);
+	}
+
+	//Index of this corner's vertex, and whether it's new.
+	std::pair<uint32_t, bool> insert(const std::array<uint32_t, 3>& key) {
+		for (size_t slot = _hash(key) & _mask;; slot = (slot + 1u) & _mask) {
+			uint32_t vertex = _slots[slot];
+			if (vertex == EMPTY) {
+				vertex = static_cast<uint32_t>(_keys.size());
+				_slots[slot] = vertex;
+				_keys.push_back(key);
+				return {vertex, true};
+			}
+			if (_keys[vertex] == key) {return {vertex, false};}
+		}
+	}
+};
+
+
+inline Mesh parse(std::string_view text) {
+	//Split at line boundaries, then parse each piece on its own thread.
+	size_t pieces = std::clamp<size_t>(text.size() / constants::misc::MESH_MIN_BYTES_PER_THREAD, 1u, constants::misc::MAX_WORKER_THREADS);
+	std::vector<Chunk> chunks(pieces);
+	size_t begin = 0u;
+	for (size_t c=0; c<pieces; c++) {
+		size_t end = (c + 1u == pieces) ? text.size() : std::max(begin, (text.size() / pieces) * (c + 1u));
+		while ((end > 0u) && (end < text.size()) && (text[end - 1u] != '\n')) {end++;}
+		chunks[c].text = text.substr(begin, end - begin);
+		begin = end;
+	}
+	simd::parallelFor(pieces, 1u, [&chunks](size_t first, size_t last) {
+		for (size_t c=first; c<last; c++) {parseChunk(chunks[c]);}
+	});
+
+
+	//Where each chunk's attributes start in the whole file.
+	size_t totals[3] = {0u, 0u, 0u};
+	size_t corners = 0u, skipped = 0u;
+	bool anyUV = false, anyNormal = false;
+	std::vector<std::array<size_t, 3>> bases(pieces);
+	for (size_t c=0; c<pieces; c++) {
+		const Chunk& chunk = chunks[c];
+		if (!chunk.error.empty()) {utils::cerr(chunk.error);}
+		bases[c] = {totals[0], totals[1], totals[2]};
+		totals[0] += chunk.positions.size() / 3u;
+		totals[1] += chunk.uvs.size() / 2u;
+		totals[2] += chunk.normals.size() / 3u;
+		corners += chunk.corners.size();
+		skipped += chunk.skippedFaces;
+		for (const Corner& corner : chunk.corners) {
+			anyUV |= (corner.index[1] != 0) || (corner.relative & 2u);
+			anyNormal |= (corner.index[2] != 0) || (corner.relative & 4u);
+		}
+	}
+	if (skipped) {GL_LOG_MINIMAL(std::format("Skipped [{}] OBJ faces with fewer than 3 corners", skipped));}
+	if (totals[0] > std::numeric_limits<uint32_t>::max() - 1u) {utils::cerr("OBJ has too many positions for 32-bit indices");}
+
+
+	Mesh out;
+	out.format = formatFor(anyUV, anyNormal);
+	size_t stride = out.stride();
+	CornerMap map(corners);
+	out.vertices.reserve(std::min(corners, totals[0] * 2u) * stride);
+
+	constexpr uint32_t ABSENT = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> faceVertices;
+	for (size_t c=0; c<pieces; c++) {
+		const Chunk& chunk = chunks[c];
+		size_t next = 0u;
+		for (uint32_t count : chunk.faces) {
+			faceVertices.clear();
+			for (uint32_t k=0; k<count; k++) {
+				const Corner& corner = chunk.corners[next++];
+
+				//To 0-based indices into the whole file's attributes.
+				std::array<uint32_t, 3> key;
+				for (size_t a=0; a<3; a++) {
+					bool relative = corner.relative & (1u << a);
+					if (!relative && (corner.index[a] == 0)) {key[a] = ABSENT; continue; /* Not given, positions always are. */}
+					int64_t index = (relative) ? (static_cast<int64_t>(bases[c][a]) + corner.index[a]) : (corner.index[a] - 1);
+					if ((index < 0) || (static_cast<size_t>(index) >= totals[a])) {
+						utils::cerr(std::format("OBJ face refers to {} [{}], but there are only [{}]", (a == 0u) ? "position" : ((a == 1u) ? "uv" : "normal"), index + 1, totals[a]));
+					}
+					key[a] = static_cast<uint32_t>(index);
+				}
+
+				auto [vertex, added] = map.insert(key);
+				if (added) {
+					//Find each attribute in whichever chunk holds it.
+					auto fetch = [&](size_t attribute, size_t width) {
+						if (key[attribute] == ABSENT) {out.vertices.insert(out.vertices.end(), width, 0.0f); return;}
+						size_t owner = pieces - 1u;
+						while (bases[owner][attribute] > key[attribute]) {owner--;}
+						const std::vector<float>& source = (attribute == 0u) ? chunks[owner].positions : ((attribute == 1u) ? chunks[owner].uvs : chunks[owner].normals);
+						const float* value = source.data() + (key[attribute] - bases[owner][attribute]) * width;
+						out.vertices.insert(out.vertices.end(), value, value + width);
+					};
+					fetch(0u, 3u);
+					if (anyUV) {fetch(1u, 2u);}
+					if (anyNormal) {fetch(2u, 3u);}
+				}
+				faceVertices.push_back(vertex);
+			}
+
+			//Fan out polygons.
+			for (size_t k=1; k+1<faceVertices.size(); k++) {
+				out.indices.insert(out.indices.end(), {faceVertices[0], faceVertices[k], faceVertices[k + 1u]});
+			}
+		}
+	}
+	return out;
+}
+
+
+}
+
+
+
+namespace glb {
+
+
+constexpr uint32_t MAGIC = 0x46546C67u;      //"glTF"
+constexpr uint32_t CHUNK_JSON = 0x4E4F534Au; //"JSON"
+constexpr uint32_t CHUNK_BIN = 0x004E4942u;  //"BIN\0"
+
+
+inline uint32_t readU32(const char* p) {uint32_t v; std::memcpy(&v, p, sizeof(v)); return v; /* glb is little-endian, like every target. */}
+
+
+//A typed window onto the binary chunk.
+struct Accessor {
+	const char* data = nullptr;
+	size_t count = 0u;
+	size_t components = 0u;
+	size_t stride = 0u;
+	GLenum componentType = GL_FLOAT;
+	bool normalized = false;
+
+	float get(size_t i, size_t c) const {
+		const char* p = data + i*stride;
+		switch (componentType) {
+			case GL_FLOAT:          {float v;    std::memcpy(&v, p + c*4u, 4u); return v;}
+			case GL_UNSIGNED_BYTE:  {uint8_t v;  std::memcpy(&v, p + c, 1u);    return normalized ? (v / 255.0f) : float(v);}
+			case GL_UNSIGNED_SHORT: {uint16_t v; std::memcpy(&v, p + c*2u, 2u); return normalized ? (v / 65535.0f) : float(v);}
+			case GL_BYTE:           {int8_t v;   std::memcpy(&v, p + c, 1u);    return normalized ? std::max(v / 127.0f, -1.0f) : float(v);}
+			case GL_SHORT:          {int16_t v;  std::memcpy(&v, p + c*2u, 2u); return normalized ? std::max(v / 32767.0f, -1.0f) : float(v);}
+			default:                {return 0.0f;}
+		}
+	}
+
+	uint32_t index(size_t i) const {
+		const char* p = data + i*stride;
+		switch (componentType) {
+			case GL_UNSIGNED_BYTE:  {uint8_t v;  std::memcpy(&v, p, 1u); return v;}
+			case GL_UNSIGNED_SHORT: {uint16_t v; std::memcpy(&v, p, 2u); return v;}
+			default:                {uint32_t v; std::memcpy(&v, p, 4u); return v;}
+		}
+	}
+};
+
+
+//A JSON number as an index, count or byte size. Raises unless it's a whole number a size_t holds exactly,
+//as casting anything else (negative, fractional, huge or NaN) is undefined.
+inline size_t whole(double value, std::string_view what) {
+	constexpr double LIMIT = 9007199254740992.0; //2^53, past which doubles skip integers
+	if (!(value >= 0.0) || (value > LIMIT) || (value != std::floor(value))) {
+		utils::cerr(std::format("glTF {} [{}] isn't a valid index or size", what, value));
+	}
+	return static_cast<size_t>(value);
+}
+
+
+inline Accessor accessor(const json::Value& gltf, double accessorIndex, std::string_view bin) {
+	const json::Value* accessors = gltf.find("accessors");
+	const json::Value* acc = (accessors && (accessorIndex >= 0.0)) ? accessors->at(whole(accessorIndex, "accessor")) : nullptr;
+	if (!acc) {utils::cerr(std::format("glTF accessor [{}] doesn't exist", accessorIndex));}
+	if (acc->find("sparse")) {utils::cerr("Sparse glTF accessors aren't supported");}
+
+	double viewIndex = acc->numberOr("bufferView", -1.0);
+	const json::Value* views = gltf.find("bufferViews");
+	const json::Value* view = (views && (viewIndex >= 0.0)) ? views->at(whole(viewIndex, "bufferView")) : nullptr;
+	if (!view) {utils::cerr(std::format("glTF accessor [{}] has no bufferView, which isn't supported", accessorIndex));}
+	if (view->numberOr("buffer", 0.0) != 0.0) {utils::cerr("Only the .glb's own binary chunk is supported as a glTF buffer");}
+
+	Accessor out;
+	std::string_view type = acc->stringOr("type", "");
+	out.components = (type == "SCALAR") ? 1u : (type == "VEC2") ? 2u : (type == "VEC3") ? 3u : (type == "VEC4") ? 4u : 0u;
+	out.componentType = static_cast<GLenum>(whole(acc->numberOr("componentType", 0.0), "componentType"));
+	size_t componentSize = 0u;
+	switch (out.componentType) {
+		case GL_BYTE: case GL_UNSIGNED_BYTE:   {componentSize = 1u; break;}
+		case GL_SHORT: case GL_UNSIGNED_SHORT: {componentSize = 2u; break;}
+		case GL_UNSIGNED_INT: case GL_FLOAT:   {componentSize = 4u; break;}
+		default: {break;}
+	}
+	if (!out.components || !componentSize) {utils::cerr(std::format("glTF accessor [{}] has an unsupported type", accessorIndex));}
+
+	const json::Value* normalized = acc->find("normalized");
+	out.normalized = normalized && normalized->boolean;
+	out.count = whole(acc->numberOr("count", 0.0), "count");
+	size_t elementSize = out.components * componentSize;
+	out.stride = whole(view->numberOr("byteStride", 0.0), "byteStride");
+	if (out.stride == 0u) {out.stride = elementSize;}
+	if (out.stride > 252u) {utils::cerr(std::format("glTF accessor [{}] has a byteStride over glTF's limit of 252", accessorIndex));}
+
+	size_t viewOffset = whole(view->numberOr("byteOffset", 0.0), "byteOffset");
+	size_t viewLength = whole(view->numberOr("byteLength", 0.0), "byteLength");
+	size_t offset = whole(acc->numberOr("byteOffset", 0.0), "byteOffset");
+	//Every element takes a byte at least, so count <= viewLength keeps the product below from overflowing.
+	bool fits = (viewOffset + viewLength <= bin.size()) && (out.count <= viewLength) && (offset <= viewLength)
+		&& ((out.count == 0u) || (offset + (out.count - 1u)*out.stride + elementSize <= viewLength));
+	if (!fits) {utils::cerr(std::format("glTF accessor [{}] reaches past the end of its buffer", accessorIndex));}
+
+	out.data = bin.data() + viewOffset + offset;
+	return out;
+}
+
+
+inline Mesh parse(std::string_view file) {
+	if ((file.size() < 12u) || (readU32(file.data()) != MAGIC)) {utils::cerr("Not a binary glTF file");}
+	if (readU32(file.data() + 4u) != 2u) {utils::cerr(std::format("Only glTF 2.0 is supported, file is version [{}]", readU32(file.data() + 4u)));}
+	file = file.substr(0u, std::min<size_t>(file.size(), readU32(file.data() + 8u)));
+
+	//Chunks: JSON first, then an optional binary one.
+	std::string_view jsonText, bin;
+	for (size_t offset = 12u; offset + 8u <= file.size();) {
+		uint32_t length = readU32(file.data() + offset);
+		uint32_t type = readU32(file.data() + offset + 4u);
+		if (offset + 8u + length > file.size()) {utils::cerr("glTF chunk reaches past the end of the file");}
+		std::string_view data = file.substr(offset + 8u, length);
+		if ((type == CHUNK_JSON) && jsonText.empty()) {jsonText = data;}
+		else if ((type == CHUNK_BIN) && bin.empty()) {bin = data;}
+		offset += 8u + ((length + 3u) & ~size_t(3u));
+	}
+	if (jsonText.empty()) {utils::cerr("glTF file has no JSON chunk");}
+	json::Value gltf = json::parse(jsonText);
+
+
+	//Every triangle primitive of every mesh, merged. Node transforms aren't applied.
+	struct Primitive {Accessor position, uvs, normals, indices; bool indexed = false;};
+	std::vector<Primitive> primitives;
+	size_t skipped = 0u;
+	bool anyUV = false, anyNormal = false;
+
+	const json::Value* meshes = gltf.find("meshes");
+	for (size_t m=0; meshes && (m<meshes->size()); m++) {
+		const json::Value* prims = meshes->at(m)->find("primitives");
+		for (size_t p=0; prims && (p<prims->size()); p++) {
+			const json::Value& prim = *(prims->at(p));
+			const json::Value* attributes = prim.find("attributes");
+			if ((prim.numberOr("mode", 4.0) != 4.0) || !attributes || !attributes->find("POSITION")) {skipped++; continue; /* Not triangles */}
+
+			//Attributes are read as floats, which get() can't do from 32 bit integers.
+			auto attribute = [&](const char* attributeName) {
+				Accessor out = accessor(gltf, attributes->numberOr(attributeName, -1.0), bin);
+				if (out.componentType == GL_UNSIGNED_INT) {utils::cerr(std::format("glTF {} can't have UNSIGNED_INT components", attributeName));}
+				return out;
+			};
+
+			Primitive entry;
+			entry.position = attribute("POSITION");
+			if (entry.position.components != 3u) {utils::cerr("glTF POSITION must be VEC3");}
+			if (attributes->find("TEXCOORD_0")) {
+				entry.uvs = attribute("TEXCOORD_0");
+				if (entry.uvs.components != 2u) {utils::cerr("glTF TEXCOORD_0 must be VEC2");}
+				if (entry.uvs.count != entry.position.count) {utils::cerr("glTF TEXCOORD_0 and POSITION counts differ");}
+				anyUV = true;
+			}
+			if (attributes->find("NORMAL")) {
+				entry.normals = attribute("NORMAL");
+				if (entry.normals.components != 3u) {utils::cerr("glTF NORMAL must be VEC3");}
+				if (entry.normals.count != entry.position.count) {utils::cerr("glTF NORMAL and POSITION counts differ");}
+				anyNormal = true;
+			}
+			entry.indexed = (prim.find("indices") != nullptr);
+			if (entry.indexed) {
+				entry.indices = accessor(gltf, prim.numberOr("indices", -1.0), bin);
+				bool unsignedType = (entry.indices.componentType == GL_UNSIGNED_BYTE) || (entry.indices.componentType == GL_UNSIGNED_SHORT) || (entry.indices.componentType == GL_UNSIGNED_INT);
+				if ((entry.indices.components != 1u) || !unsignedType) {utils::cerr("glTF indices must be SCALAR unsigned integers");}
+			}
+			primitives.push_back(entry);
+		}
+	}
+	if (skipped) {GL_LOG_MINIMAL(std::format("Skipped [{}] glTF primitives that aren't triangle lists", skipped));}
+
+
+	Mesh out;
+	out.format = formatFor(anyUV, anyNormal);
+	size_t vertexTotal = 0u, indexTotal = 0u;
+	for (const Primitive& prim : primitives) {
+		vertexTotal += prim.position.count;
+		indexTotal += (prim.indexed) ? prim.indices.count : prim.position.count;
+	}
+	out.vertices.reserve(vertexTotal * out.stride());
+	out.indices.reserve(indexTotal);
+
+	for (const Primitive& prim : primitives) {
+		GLuint base = static_cast<GLuint>(out.vertexCount());
+		bool hasUV = (prim.uvs.data != nullptr), hasNormal = (prim.normals.data != nullptr);
+		for (size_t i=0; i<prim.position.count; i++) {
+			for (size_t c=0; c<3; c++) {out.vertices.push_back(prim.position.get(i, c));}
+			if (anyUV) {for (size_t c=0; c<2; c++) {out.vertices.push_back((hasUV) ? prim.uvs.get(i, c) : 0.0f);}}
+			if (anyNormal) {for (size_t c=0; c<3; c++) {out.vertices.push_back((hasNormal) ? prim.normals.get(i, c) : 0.0f);}}
+		}
+
+		if (prim.indexed) {
+			for (size_t i=0; i<prim.indices.count; i++) {
+				uint32_t index = prim.indices.index(i);
+				if (index >= prim.position.count) {utils::cerr(std::format("glTF index [{}] is past the primitive's [{}] vertices", index, prim.position.count));}
+				out.indices.push_back(base + index);
+			}
+		} else {
+			for (size_t i=0; i<prim.position.count; i++) {out.indices.push_back(base + static_cast<GLuint>(i));}
+		}
+	}
+	return out;
+}
+
+
+}
+
+
+
+//Parse a .obj or .glb file, by extension.
+inline Mesh load(const std::string& filePath) {
+	std::string extension = std::filesystem::path(filePath).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {return static_cast<char>(std::tolower(c));});
+	if ((extension != ".obj") && (extension != ".glb")) {
+		utils::cerr(std::format("Unsupported mesh format [{}] of file: {}, expected .obj or .glb", extension, filePath));
+	}
+
+	MappedFile file(filePath);
+	Mesh out = (extension == ".obj") ? obj::parse(file.view()) : glb::parse(file.view());
+	if (out.indices.empty()) {utils::cerr(std::format("Mesh file has no triangles: {}", filePath));}
+	out.computeBounds();
+	return out;
+}
+
+
+}
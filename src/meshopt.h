@@ -0,0 +1,253 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+#include "utils.h"
+
+#include <limits>
+
+
+
+//Index & vertex buffer optimisation, run once before upload. All passes are linear (bar one sort of clusters).
+//	1. Vertex cache: Tipsify (Sander, Nehab & Barczak 2007) reorders triangles so a vertex gets reused while
+//	   it's still in the post-transform cache.
+//	2. Overdraw: the cache-ordered triangles are cut into clusters, only where a cut costs little cache
+//	   efficiency, and clusters facing out from the mesh's centre (likely occluders) are drawn first.
+//	3. Vertex fetch: vertices are renumbered by first use, so fetches walk the vertex buffer forwards.
+//Vertices are interleaved floats of `stride`, position first, as every VAOFormat is.
+namespace meshopt {
+
+
+//Average cache miss ratio: vertices transformed per triangle through a FIFO cache.
+//3 is the worst possible, about 0.5 the best a large regular grid can do.
+struct Stats {
+	float acmrBefore = 0.0f;
+	float acmrAfter = 0.0f;
+};
+
+
+//Simulated FIFO post-transform cache. A vertex is cached if it went in within the last `size` misses.
+class FIFOCache {
+private:
+	std::vector<size_t> _stamp; //Miss count when each vertex last went in.
+	size_t _size = 0u;
+	size_t _time = 0u;
+
+public:
+	FIFOCache(size_t vertexCount, size_t size) : _stamp(vertexCount, 0u), _size(size), _time(size + 1u) {}
+
+	//True on a miss, which also inserts it.
+	bool miss(GLuint v) {
+		if ((_time - _stamp[v]) <= _size) {return false;}
+		_stamp[v] = _time++;
+		return true;
+	}
+
+	//Misses since v went in, it's cached while this is <= size.
+	size_t age(GLuint v) const {return _time - _stamp[v];}
+
+	void flush() {_time += _size + 1u;}
+};
+
+
+inline float acmr(const std::vector<GLuint>& indices, size_t vertexCount, size_t cacheSize) {
+	if (indices.size() < 3u) {return 0.0f;}
+	FIFOCache cache(vertexCount, cacheSize);
+	size_t misses = 0u;
+	for (GLuint v : indices) {misses += cache.miss(v);}
+	return float(misses) / float(indices.size() / 3u);
+}
+
+
+
+//Tipsify. Fans around one vertex at a time, then moves to whichever vertex just used will still be cached
+//once its remaining triangles are drawn; failing that, back through recently used vertices (dead ends).
+inline std::vector<GLuint> vertexCache(const std::vector<GLuint>& indices, size_t vertexCount, size_t cacheSize) {
+	size_t triangles = indices.size() / 3u;
+
+	//Triangles using each vertex.
+	std::vector<uint32_t> offsets(vertexCount + 1u, 0u);
+	for (GLuint v : indices) {offsets[v + 1u]++;}
+	for (size_t v=0; v<vertexCount; v++) {offsets[v + 1u] += offsets[v];}
+	std::vector<uint32_t> adjacency(indices.size());
+	{
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t i=0; i<indices.size(); i++) {adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3u);}
+	}
+
+	std::vector<uint32_t> live(vertexCount); //Triangles left to draw, per vertex
+	for (size_t v=0; v<vertexCount; v++) {live[v] = offsets[v + 1u] - offsets[v];}
+	std::vector<uint8_t> emitted(triangles, 0u);
+	std::vector<GLuint> deadEnd;
+	deadEnd.reserve(indices.size());
+	std::vector<GLuint> candidates;
+	FIFOCache cache(vertexCount, cacheSize);
+	size_t cursor = 0u;
+
+	auto skipDeadEnd = [&]() -> int64_t {
+		while (!deadEnd.empty()) {
+			GLuint v = deadEnd.back();
+			deadEnd.pop_back();
+			if (live[v] > 0u) {return v;}
+		}
+		for (; cursor<vertexCount; cursor++) {
+			if (live[cursor] > 0u) {return static_cast<int64_t>(cursor);}
+		}
+		return -1;
+	};
+
+	std::vector<GLuint> out;
+	out.reserve(indices.size());
+	for (int64_t fan = skipDeadEnd(); fan >= 0;) {
+		candidates.clear();
+		for (uint32_t a=offsets[fan]; a<offsets[fan + 1]; a++) {
+			uint32_t t = adjacency[a];
+			if (emitted[t]) {continue;}
+			emitted[t] = 1u;
+			for (size_t k=0; k<3; k++) {
+				GLuint v = indices[t*3u + k];
+				out.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				live[v]--;
+				cache.miss(v);
+			}
+		}
+
+		//Oldest candidate that survives its own remaining triangles (2 new vertices each, at worst).
+		int64_t next = -1;
+		size_t best = 0u;
+		for (GLuint v : candidates) {
+			if (live[v] == 0u) {continue;}
+			size_t priority = ((cache.age(v) + 2u*live[v]) <= cacheSize) ? cache.age(v) : 0u;
+			if ((next < 0) || (priority > best)) {next = v; best = priority;}
+		}
+		fan = (next >= 0) ? next : skipDeadEnd();
+	}
+	return out;
+}
+
+
+
+//Cluster sort for overdraw. Hard cuts go where the cache-ordered mesh jumps (a triangle missing all 3 vertices),
+//soft cuts wherever the cluster so far is within `threshold` of its hard cluster's ACMR.
+inline std::vector<GLuint> overdraw(const std::vector<GLuint>& indices, const std::vector<float>& vertices, size_t stride, size_t cacheSize, float threshold) {
+	size_t triangles = indices.size() / 3u;
+	size_t vertexCount = vertices.size() / stride;
+	auto position = [&](GLuint v) {return glm::make_vec3(vertices.data() + size_t(v)*stride);};
+
+	FIFOCache cache(vertexCount, cacheSize);
+	auto missesOf = [&](size_t t) {
+		return cache.miss(indices[t*3u]) + cache.miss(indices[t*3u + 1u]) + cache.miss(indices[t*3u + 2u]);
+	};
+
+	std::vector<uint32_t> hard;
+	std::vector<uint8_t> misses(triangles);
+	for (size_t t=0; t<triangles; t++) {
+		misses[t] = static_cast<uint8_t>(missesOf(t));
+		if ((t == 0u) || (misses[t] == 3u)) {hard.push_back(static_cast<uint32_t>(t));}
+	}
+	hard.push_back(static_cast<uint32_t>(triangles));
+
+	std::vector<uint32_t> clusters;
+	for (size_t h=0; h+1<hard.size(); h++) {
+		size_t begin = hard[h], end = hard[h + 1u];
+		size_t clusterMisses = 0u;
+		for (size_t t=begin; t<end; t++) {clusterMisses += misses[t];}
+		float limit = threshold * float(clusterMisses) / float(end - begin);
+
+		cache.flush();
+		clusters.push_back(static_cast<uint32_t>(begin));
+		size_t partMisses = 0u, partSize = 0u;
+		for (size_t t=begin; t<end; t++) {
+			partMisses += missesOf(t);
+			partSize++;
+			if ((t + 1u < end) && (float(partMisses) <= limit * float(partSize))) {
+				clusters.push_back(static_cast<uint32_t>(t + 1u));
+				partMisses = partSize = 0u;
+				cache.flush();
+			}
+		}
+	}
+	clusters.push_back(static_cast<uint32_t>(triangles));
+
+
+	//Clusters facing away from the centre first, they're the ones most likely to hide the rest.
+	glm::vec3 meshCentre = glm::vec3(0.0f);
+	for (size_t v=0; v<vertexCount; v++) {meshCentre += position(static_cast<GLuint>(v));}
+	meshCentre /= float(std::max<size_t>(vertexCount, 1u));
+
+	size_t clusterCount = clusters.size() - 1u;
+	std::vector<float> facing(clusterCount);
+	for (size_t c=0; c<clusterCount; c++) {
+		glm::vec3 centre = glm::vec3(0.0f), normal = glm::vec3(0.0f);
+		float area = 0.0f;
+		for (size_t t=clusters[c]; t<clusters[c + 1u]; t++) {
+			glm::vec3 a = position(indices[t*3u]), b = position(indices[t*3u + 1u]), d = position(indices[t*3u + 2u]);
+			glm::vec3 n = glm::cross(b - a, d - a); //Length = twice the area
+			float weight = glm::length(n);
+			centre += (a + b + d) * (weight / 3.0f);
+			normal += n;
+			area += weight;
+		}
+		float normalLength = glm::length(normal);
+		if ((area <= 0.0f) || (normalLength <= 0.0f)) {facing[c] = 0.0f; continue; /* Degenerate */}
+		facing[c] = glm::dot((centre / area) - meshCentre, normal / normalLength);
+	}
+
+	std::vector<uint32_t> order(clusterCount);
+	for (size_t c=0; c<clusterCount; c++) {order[c] = static_cast<uint32_t>(c);}
+	std::stable_sort(order.begin(), order.end(), [&facing](uint32_t a, uint32_t b) {return facing[a] > facing[b];});
+
+	std::vector<GLuint> out;
+	out.reserve(indices.size());
+	for (uint32_t c : order) {
+		out.insert(out.end(), indices.begin() + size_t(clusters[c])*3u, indices.begin() + size_t(clusters[c + 1u])*3u);
+	}
+	return out;
+}
+
+
+
+//Renumber vertices by first use. Vertices no triangle uses are dropped.
+inline void vertexFetch(std::vector<float>& vertices, size_t stride, std::vector<GLuint>& indices) {
+	constexpr GLuint UNUSED = std::numeric_limits<GLuint>::max();
+	std::vector<GLuint> remap(vertices.size() / stride, UNUSED);
+	std::vector<float> out;
+	out.reserve(vertices.size());
+
+	GLuint next = 0u;
+	for (GLuint& index : indices) {
+		if (remap[index] == UNUSED) {
+			remap[index] = next++;
+			out.insert(out.end(), vertices.begin() + size_t(index)*stride, vertices.begin() + size_t(index + 1u)*stride);
+		}
+		index = remap[index];
+	}
+	vertices.swap(out);
+}
+
+
+
+//All three passes, in place.
+inline Stats optimize(std::vector<float>& vertices, size_t stride, std::vector<GLuint>& indices) {
+	const size_t cacheSize = constants::misc::VERTEX_CACHE_SIZE;
+	Stats stats;
+	if ((stride < 3u) || (indices.size() < 3u) || ((indices.size() % 3u) != 0u)) {
+		return stats; //No positions, or not a triangle list; nothing to do.
+	}
+
+	size_t vertexCount = vertices.size() / stride;
+	for (GLuint index : indices) {
+		if (index >= vertexCount) {utils::cerr(std::format("Index [{}] is past the [{}] vertices given", index, vertexCount));}
+	}
+
+	stats.acmrBefore = acmr(indices, vertexCount, cacheSize);
+	indices = vertexCache(indices, vertexCount, cacheSize);
+	indices = overdraw(indices, vertices, stride, cacheSize, constants::misc::OVERDRAW_THRESHOLD);
+	vertexFetch(vertices, stride, indices);
+	stats.acmrAfter = acmr(indices, vertices.size() / stride, cacheSize);
+	return stats;
+}
+
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+#include "utils.h"
+
+#include <chrono>
+#include <mutex>
+
+
+
+//Frame pacing.
+//Each gl.update_window() records the time from the previous swap returning (the frame's CPU start) to
+//this swap returning, in a fixed ring. An optional limiter sleeps out the rest of the frame so an
+//uncapped loop doesn't spin a core.
+namespace pacing {
+
+
+using Clock = std::chrono::steady_clock;
+
+
+//Summary of the recent frames, in milliseconds.
+struct FrameStats {
+	size_t frames = 0u;
+	double mean = 0.0;
+	double p50 = 0.0;
+	double p99 = 0.0;
+	double target = 0.0; //Expected frame time, 0 if unknown/uncapped.
+	size_t missed = 0u; //Frames that took over 1.5x the target.
+};
+
+
+//The ring is written by gl.update_window() with the GIL released, so gl.frame_stats() on another Python thread
+//can read it at the same time. Everything else here belongs to the context thread.
+inline std::mutex ringMutex;
+inline std::array<double, constants::misc::FRAME_RING> frameTimes = {}; //[ms]
+inline size_t head = 0u;
+inline size_t count = 0u;
+
+inline Clock::time_point lastSwap = {}; //Start of the current frame.
+inline bool started = false;
+
+inline int swapInterval = 0; //As passed to glfwSwapInterval, 0 is uncapped.
+inline double refreshRate = 0.0; //Of the monitor, [Hz] 0 if unknown (headless).
+inline Clock::duration limit = Clock::duration::zero(); //Limiter's frame time, zero when off.
+inline Clock::time_point deadline = {}; //When the limiter lets the current frame end.
+
+
+//Expected frame time [ms]; the limiter wins over vsync if it's slower.
+inline double targetFrameTime() {
+	double vsync = ((swapInterval != 0) && (refreshRate > 0.0)) ? (std::abs(swapInterval) * 1000.0 / refreshRate) : 0.0;
+	double limiter = std::chrono::duration<double, std::milli>(limit).count();
+	return std::max(vsync, limiter);
+}
+
+
+//Sleep until the limiter's deadline. Sleeps coarsely, then yields through the last bit for accuracy.
+inline void wait() {
+	if (limit == Clock::duration::zero() || !started) {return;}
+
+	Clock::time_point now = Clock::now();
+	if (deadline <= lastSwap || (now - deadline) > limit) {
+		deadline = lastSwap + limit; //First frame, or fell behind by a whole frame; don't try to catch up.
+	}
+
+	constexpr auto SLACK = std::chrono::milliseconds(1);
+	if ((deadline - now) > SLACK) {std::this_thread::sleep_until(deadline - SLACK);}
+	while (Clock::now() < deadline) {std::this_thread::yield();}
+	deadline += limit;
+}
+
+
+//Call when the swap returns; ends one frame and starts the next.
+inline void endFrame() {
+	Clock::time_point now = Clock::now();
+	if (started) {
+		std::lock_guard<std::mutex> lock(ringMutex);
+		frameTimes[head] = std::chrono::duration<double, std::milli>(now - lastSwap).count();
+		head = (head + 1u) % frameTimes.size();
+		count = std::min(count + 1u, frameTimes.size());
+	}
+	lastSwap = now;
+	started = true;
+}
+
+
+inline FrameStats stats() {
+	FrameStats out;
+	out.target = targetFrameTime();
+	std::vector<double> sorted;
+	{
+		std::lock_guard<std::mutex> lock(ringMutex);
+		sorted.assign(frameTimes.begin(), frameTimes.begin() + count);
+	}
+	size_t count = sorted.size();
+	out.frames = count;
+	if (count == 0u) {return out;}
+
+	std::sort(sorted.begin(), sorted.end());
+
+	double total = 0.0;
+	for (double t : sorted) {
+		total += t;
+		if ((out.target > 0.0) && (t > out.target * 1.5)) {out.missed++;}
+	}
+	out.mean = total / static_cast<double>(count);
+	out.p50 = sorted[count / 2u];
+	out.p99 = sorted[std::min(count - 1u, (count * 99u) / 100u)];
+	return out;
+}
+
+
+//Forget the recorded frames. Safe from any thread.
+inline void clearFrames() {
+	std::lock_guard<std::mutex> lock(ringMutex);
+	head = 0u;
+	count = 0u;
+}
+
+//Forget the recorded frames, and don't time the one in progress. Context thread only.
+inline void clear() {
+	clearFrames();
+	started = false;
+}
+
+inline void reset() {
+	clear();
+	swapInterval = 0;
+	refreshRate = 0.0;
+	limit = Clock::duration::zero();
+	deadline = {};
+}
+
+
+}
@@ -0,0 +1,253 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+#include "utils.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+
+
+//CPU frame profiler.
+//Scoped zones write {name, start, end} into a ring owned by the calling thread. Only that thread writes
+//its ring, so pushing never locks or waits; gl.profiler_dump() reads every ring and writes them out as
+//Chrome trace JSON (chrome://tracing, Perfetto), alongside GPU timestamps.
+//Define GL_NO_PROFILER to compile the zones out entirely.
+namespace profiler {
+
+
+//One timed zone. GPU events have no name pointer, they refer to a shader ID instead.
+struct Event {
+	const char* name = nullptr; //Static string, CPU zones only
+	int64_t start = 0; //ns since profiler epoch
+	int64_t end = 0;
+	int shaderID = -1; //GPU events only
+};
+
+
+//Single-producer ring. Owner thread pushes, dump reads.
+//Each slot is a seqlock tagged with the push it holds, so a reader copies a slot only if the owner didn't rewrite it
+//mid-copy. Every field is atomic, the owner never waits. Only readers move the tail (on clear), only the owner the head.
+class Ring {
+private:
+	static constexpr size_t SIZE = constants::misc::PROFILER_RING;
+	static_assert((SIZE & (SIZE - 1u)) == 0u, "Profiler ring size must be a power of 2");
+
+	struct Slot {
+		std::atomic<uint64_t> sequence = 0u; //2*push + 1 while writing push, 2*push + 2 once written
+		std::atomic<const char*> name = nullptr;
+		std::atomic<int64_t> start = 0;
+		std::atomic<int64_t> end = 0;
+		std::atomic<int> shaderID = -1;
+	};
+
+	std::array<Slot, SIZE> _slots = {};
+	std::atomic<uint64_t> _head = 0u; //Next push, owner only
+	std::atomic<uint64_t> _tail = 0u; //First push not cleared, readers only (under the registry lock)
+	std::atomic<bool> _retired = false;
+
+public:
+	const uint32_t threadID;
+	const bool gpu; //Holds GPU events rather than CPU zones.
+
+	Ring(uint32_t tid, bool isGPU) : threadID(tid), gpu(isGPU) {}
+
+	inline void push(const Event& e) {
+		uint64_t head = _head.load(std::memory_order_relaxed);
+		Slot& slot = _slots[head & (SIZE - 1u)];
+		slot.sequence.store(2u*head + 1u, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.name.store(e.name, std::memory_order_relaxed);
+		slot.start.store(e.start, std::memory_order_relaxed);
+		slot.end.store(e.end, std::memory_order_relaxed);
+		slot.shaderID.store(e.shaderID, std::memory_order_relaxed);
+		slot.sequence.store(2u*head + 2u, std::memory_order_release);
+		_head.store(head + 1u, std::memory_order_release);
+	}
+
+	//Copy out whatever is still in the ring since the last clear. Slots the owner rewrote mid-copy are dropped.
+	std::vector<Event> snapshot() const {
+		uint64_t head = _head.load(std::memory_order_acquire);
+		uint64_t first = std::max(_tail.load(std::memory_order_relaxed), (head > SIZE) ? (head - SIZE) : 0u);
+
+		std::vector<Event> out;
+		out.reserve(static_cast<size_t>(head - std::min(first, head)));
+		for (uint64_t i=first; i<head; i++) {
+			const Slot& slot = _slots[i & (SIZE - 1u)];
+			uint64_t before = slot.sequence.load(std::memory_order_acquire);
+			if (before != (2u*i + 2u)) {continue; /* Being rewritten, or already holds a later push */}
+
+			Event e = {
+				slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+				slot.end.load(std::memory_order_relaxed), slot.shaderID.load(std::memory_order_relaxed)
+			};
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.sequence.load(std::memory_order_relaxed) == before) {out.push_back(e);}
+		}
+		return out;
+	}
+
+	//Everything pushed so far is skipped by later snapshots. The owner keeps pushing at its own head.
+	void clear() {_tail.store(_head.load(std::memory_order_acquire), std::memory_order_relaxed);}
+
+	void retire() {_retired.store(true, std::memory_order_release);}
+	bool retired() const {return _retired.load(std::memory_order_acquire);}
+};
+
+
+inline std::atomic<bool> enabled = false;
+inline const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+inline int64_t gpuOffset = 0; //Add to a GPU timestamp to get profiler time. Set when enabled.
+
+inline std::mutex registryMutex; //Only taken when a thread first records or exits, or on dump.
+inline std::vector<std::unique_ptr<Ring>> rings;
+inline uint32_t nextThreadID = 0u;
+
+
+inline int64_t now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+
+inline Ring& newRing(bool gpu) {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	rings.push_back(std::make_unique<Ring>(nextThreadID++, gpu));
+	return *rings.back();
+}
+
+//Rings of threads that have exited, once dumped or cleared, are freed. Needs the registry lock.
+inline void freeRetired() {
+	std::erase_if(rings, [](const std::unique_ptr<Ring>& ring) {return ring->retired();});
+}
+
+
+//Retires the thread's ring when it exits, so the ring is freed on the next dump/clear.
+struct ThreadRing {
+	Ring& ring = newRing(false);
+	~ThreadRing() {ring.retire();}
+};
+
+inline Ring& threadRing() {
+	thread_local ThreadRing owner;
+	return owner.ring;
+}
+
+inline Ring& gpuRing() {
+	static Ring& ring = newRing(true);
+	return ring;
+}
+
+
+//GPU timestamps come from timing.h as raw GL_TIMESTAMP values.
+inline void gpuEvent(int shaderID, uint64_t gpuStart, uint64_t gpuEnd) {
+	if (!enabled.load(std::memory_order_relaxed)) {return;}
+	gpuRing().push(Event{
+		nullptr,
+		static_cast<int64_t>(gpuStart) + gpuOffset,
+		static_cast<int64_t>(gpuEnd) + gpuOffset,
+		shaderID
+	});
+}
+
+
+//Times the scope it is declared in, if the profiler is enabled when it starts.
+class Zone {
+private:
+	const char* _name;
+	int64_t _start = 0;
+	bool _active;
+
+public:
+	explicit Zone(const char* name)
+		: _name(name), _active(enabled.load(std::memory_order_relaxed)) {
+		if (_active) {_start = now();}
+	}
+
+	~Zone() {
+		if (_active) {threadRing().push(Event{_name, _start, now(), -1});}
+	}
+
+	Zone(const Zone&) = delete;
+	Zone& operator=(const Zone&) = delete;
+};
+
+
+static std::string escapeJSON(const std::string& s) {
+	std::string out;
+	out.reserve(s.size());
+	for (char c : s) {
+		switch (c) {
+			case '"':  {out += "\\\""; break;}
+			case '\\': {out += "\\\\"; break;}
+			case '\n': {out += "\\n"; break;}
+			case '\t': {out += "\\t"; break;}
+			default: {
+				if (static_cast<unsigned char>(c) < 0x20u) {out += std::format("\\u{:04x}", static_cast<int>(c));}
+				else {out += c;}
+			}
+		}
+	}
+	return out;
+}
+
+
+//Write every ring as Chrome trace JSON. GPU event names come from the resolver (shader ID → name).
+//Returns the number of events written.
+static size_t dump(const std::string& filePath, const std::function<std::string(int)>& shaderName) {
+	std::ofstream file(filePath, std::ios::binary);
+	if (!file.is_open()) {
+		utils::cerr(std::format("Could not open profiler output file: {}", filePath));
+	}
+
+	//(thread ID, GPU, events) copied out, as exited threads' rings are freed once read.
+	std::vector<std::tuple<uint32_t, bool, std::vector<Event>>> captured;
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		for (const auto& ring : rings) {captured.emplace_back(ring->threadID, ring->gpu, ring->snapshot());}
+		freeRetired();
+	}
+
+	size_t count = 0u;
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	file << R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"CPU"}},)" << "\n";
+	file << R"({"name":"process_name","ph":"M","pid":2,"args":{"name":"GPU"}})";
+
+	for (const auto& [threadID, gpu, events] : captured) {
+		int pid = (gpu) ? 2 : 1;
+		for (const Event& e : events) {
+			std::string name = (e.name) ? std::string(e.name) : shaderName(e.shaderID);
+			file << std::format(
+				",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":{},\"tid\":{}}}",
+				escapeJSON(name), (gpu) ? "gpu" : "cpu",
+				static_cast<double>(e.start) / 1000.0, static_cast<double>(e.end - e.start) / 1000.0,
+				pid, threadID
+			);
+			count++;
+		}
+	}
+	file << "\n]}\n";
+	return count;
+}
+
+
+inline void clear() {
+	std::lock_guard<std::mutex> lock(registryMutex);
+	for (auto& ring : rings) {ring->clear();}
+	freeRetired();
+}
+
+
+}
+
+
+
+#ifdef GL_NO_PROFILER
+	#define PROFILE_ZONE(name)
+#else
+	#define PROFILE_CONCAT_INNER(a, b) a##b
+	#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+	#define PROFILE_ZONE(name) profiler::Zone PROFILE_CONCAT(profileZone_, __COUNTER__)(name)
+#endif
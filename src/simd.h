@@ -0,0 +1,317 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define GL_SIMD_X86
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#endif
+#endif
+
+
+
+//Batched maths over plain float arrays, for work done per object every frame.
+//Kernels are written once (simd_kernels.h) against a small vector type and compiled for SSE2 and AVX2;
+//the widest one the CPU supports is picked at runtime, with a plain scalar loop for everything else.
+//Large batches are split across threads.
+namespace simd {
+
+
+enum Level {
+	SIMD_SCALAR,
+	SIMD_SSE2,
+	SIMD_AVX2
+};
+
+
+inline Level detect() {
+#ifdef GL_SIMD_X86
+	#if defined(__GNUC__) || defined(__clang__)
+		__builtin_cpu_init();
+		return (__builtin_cpu_supports("avx2")) ? SIMD_AVX2 : SIMD_SSE2;
+	#elif defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 1);
+		bool osAVX = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6u) == 6u); //OSXSAVE, AVX, YMM state
+		__cpuidex(info, 7, 0);
+		return (osAVX && (info[1] & (1 << 5))) ? SIMD_AVX2 : SIMD_SSE2;
+	#else
+		return SIMD_SSE2;
+	#endif
+#else
+	return SIMD_SCALAR;
+#endif
+}
+
+inline Level level = detect();
+
+inline const char* levelName(Level l) {
+	switch (l) {
+		case SIMD_AVX2: {return "AVX2";}
+		case SIMD_SSE2: {return "SSE2";}
+		default:        {return "scalar";}
+	}
+}
+
+
+
+//Frustum planes (a, b, c, d), normalised and pointing inwards: a point p is inside a plane if dot(abc, p) + d >= 0.
+struct Frustum {
+	float planes[6][4];
+	float absNormals[6][3]; //|abc|, for projecting box extents onto each normal.
+};
+
+
+//Gribb/Hartmann: the planes are sums/differences of the clip matrix's rows. m is column-major (glm).
+inline Frustum extractFrustum(const float* m) {
+	auto row = [m](int r, int c) {return m[c*4 + r];};
+
+	Frustum f;
+	for (int p=0; p<6; p++) {
+		int axis = p / 2;
+		float sign = (p % 2 == 0) ? 1.0f : -1.0f; //Left/bottom/near add the row, right/top/far subtract it.
+		float plane[4];
+		for (int c=0; c<4; c++) {plane[c] = row(3, c) + sign * row(axis, c);}
+
+		float length = std::sqrt(plane[0]*plane[0] + plane[1]*plane[1] + plane[2]*plane[2]);
+		float inv = (length > 0.0f) ? (1.0f / length) : 0.0f;
+		for (int c=0; c<4; c++) {f.planes[p][c] = plane[c] * inv;}
+		for (int c=0; c<3; c++) {f.absNormals[p][c] = std::abs(f.planes[p][c]);}
+	}
+	return f;
+}
+
+
+
+namespace scalar {
+
+//Reference version, see matrices::getModelMatrix().
+inline void modelMatrix(const float* position, const float* rotation, const float* scale, float* out) {
+	float sx = std::sin(rotation[0]), cx = std::cos(rotation[0]);
+	float sy = std::sin(rotation[1]), cy = std::cos(rotation[1]);
+	float sz = std::sin(rotation[2]), cz = std::cos(rotation[2]);
+
+	const float m[16] = {
+		cy*cz*scale[0],             cy*sz*scale[0],             -sy*scale[0],   position[0],
+		(sx*sy*cz-cx*sz)*scale[1],  (sx*sy*sz+cx*cz)*scale[1],  sx*cy*scale[1], position[1],
+		(cx*sy*cz+sx*sz)*scale[2],  (cx*sy*sz-sx*cz)*scale[2],  cx*cy*scale[2], position[2],
+		0.0f,                       0.0f,                       0.0f,           1.0f
+	};
+	std::memcpy(out, m, sizeof(m));
+}
+
+
+//Stride 4 is a sphere (centre, radius), stride 6 an AABB (min, max).
+inline bool cull(const float* b, size_t stride, const Frustum& f) {
+	float centre[3], extent[3], radius = 0.0f;
+	if (stride == 4u) {
+		for (int a=0; a<3; a++) {centre[a] = b[a]; extent[a] = 0.0f;}
+		radius = b[3];
+	} else {
+		for (int a=0; a<3; a++) {centre[a] = (b[a] + b[3 + a]) * 0.5f; extent[a] = (b[3 + a] - b[a]) * 0.5f;}
+	}
+
+	for (int p=0; p<6; p++) {
+		const float* plane = f.planes[p];
+		float distance = plane[0]*centre[0] + plane[1]*centre[1] + plane[2]*centre[2] + plane[3];
+		float reach = radius + f.absNormals[p][0]*extent[0] + f.absNormals[p][1]*extent[1] + f.absNormals[p][2]*extent[2];
+		if (distance + reach < 0.0f) {return false;}
+	}
+	return true;
+}
+
+}
+
+
+
+#ifdef GL_SIMD_X86
+
+//SSE2 is part of x86-64, so needs no target switch.
+namespace sse2 {
+
+struct V {
+	using F = __m128;
+	using I = __m128i;
+	static constexpr size_t W = 4u;
+
+	static F set1(float f) {return _mm_set1_ps(f);}
+	static I seti(int i) {return _mm_set1_epi32(i);}
+	static F load(const float* p) {return _mm_load_ps(p);}
+	static F add(F a, F b) {return _mm_add_ps(a, b);}
+	static F sub(F a, F b) {return _mm_sub_ps(a, b);}
+	static F mul(F a, F b) {return _mm_mul_ps(a, b);}
+	static F and_(F a, F b) {return _mm_and_ps(a, b);}
+	static F andnot(F a, F b) {return _mm_andnot_ps(a, b);} //~a & b
+	static F xor_(F a, F b) {return _mm_xor_ps(a, b);}
+	static I cvtt(F a) {return _mm_cvttps_epi32(a);}
+	static F cvt(I a) {return _mm_cvtepi32_ps(a);}
+	static F castF(I a) {return _mm_castsi128_ps(a);}
+	static I addi(I a, I b) {return _mm_add_epi32(a, b);}
+	static I subi(I a, I b) {return _mm_sub_epi32(a, b);}
+	static I andi(I a, I b) {return _mm_and_si128(a, b);}
+	static I andnoti(I a, I b) {return _mm_andnot_si128(a, b);} //~a & b
+	static I cmpeqi(I a, I b) {return _mm_cmpeq_epi32(a, b);}
+	static I slli29(I a) {return _mm_slli_epi32(a, 29);}
+	static F cmpge(F a, F b) {return _mm_cmpge_ps(a, b);}
+	static unsigned movemask(F a) {return static_cast<unsigned>(_mm_movemask_ps(a));}
+
+	//Lanes hold one component each; transpose so each object's column is written contiguously.
+	static void storeColumn(float* out, size_t column, F x, F y, F z, F w) {
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(out + 0*16 + column*4, x);
+		_mm_storeu_ps(out + 1*16 + column*4, y);
+		_mm_storeu_ps(out + 2*16 + column*4, z);
+		_mm_storeu_ps(out + 3*16 + column*4, w);
+	}
+};
+
+#include "simd_kernels.h"
+
+}
+
+
+
+//AVX2 code is compiled for that target only, and only run after detect() says so.
+#if defined(__clang__)
+	#pragma clang attribute push(__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+	#pragma GCC push_options
+	#pragma GCC target("avx2")
+#endif
+
+namespace avx2 {
+
+struct V {
+	using F = __m256;
+	using I = __m256i;
+	static constexpr size_t W = 8u;
+
+	static F set1(float f) {return _mm256_set1_ps(f);}
+	static I seti(int i) {return _mm256_set1_epi32(i);}
+	static F load(const float* p) {return _mm256_load_ps(p);}
+	static F add(F a, F b) {return _mm256_add_ps(a, b);}
+	static F sub(F a, F b) {return _mm256_sub_ps(a, b);}
+	static F mul(F a, F b) {return _mm256_mul_ps(a, b);}
+	static F and_(F a, F b) {return _mm256_and_ps(a, b);}
+	static F andnot(F a, F b) {return _mm256_andnot_ps(a, b);} //~a & b
+	static F xor_(F a, F b) {return _mm256_xor_ps(a, b);}
+	static I cvtt(F a) {return _mm256_cvttps_epi32(a);}
+	static F cvt(I a) {return _mm256_cvtepi32_ps(a);}
+	static F castF(I a) {return _mm256_castsi256_ps(a);}
+	static I addi(I a, I b) {return _mm256_add_epi32(a, b);}
+	static I subi(I a, I b) {return _mm256_sub_epi32(a, b);}
+	static I andi(I a, I b) {return _mm256_and_si256(a, b);}
+	static I andnoti(I a, I b) {return _mm256_andnot_si256(a, b);} //~a & b
+	static I cmpeqi(I a, I b) {return _mm256_cmpeq_epi32(a, b);}
+	static I slli29(I a) {return _mm256_slli_epi32(a, 29);}
+	static F cmpge(F a, F b) {return _mm256_cmp_ps(a, b, _CMP_GE_OQ);}
+	static unsigned movemask(F a) {return static_cast<unsigned>(_mm256_movemask_ps(a));}
+
+	//Two 4x4 transposes, one per 128-bit half.
+	static void storeColumn(float* out, size_t column, F x, F y, F z, F w) {
+		for (size_t half=0; half<2; half++) {
+			__m128 x4 = (half) ? _mm256_extractf128_ps(x, 1) : _mm256_castps256_ps128(x);
+			__m128 y4 = (half) ? _mm256_extractf128_ps(y, 1) : _mm256_castps256_ps128(y);
+			__m128 z4 = (half) ? _mm256_extractf128_ps(z, 1) : _mm256_castps256_ps128(z);
+			__m128 w4 = (half) ? _mm256_extractf128_ps(w, 1) : _mm256_castps256_ps128(w);
+			_MM_TRANSPOSE4_PS(x4, y4, z4, w4);
+			float* o = out + half*64;
+			_mm_storeu_ps(o + 0*16 + column*4, x4);
+			_mm_storeu_ps(o + 1*16 + column*4, y4);
+			_mm_storeu_ps(o + 2*16 + column*4, z4);
+			_mm_storeu_ps(o + 3*16 + column*4, w4);
+		}
+	}
+};
+
+#include "simd_kernels.h"
+
+//Whole ranges in one call, so the loops are compiled for AVX2 too.
+inline void modelMatricesRange(const float* positions, const float* rotations, const float* scales, float* out, size_t count) {
+	for (size_t i=0; i<count; i+=V::W) {modelMatrices(positions + i*3, rotations + i*3, scales + i*3, out + i*16);}
+}
+
+inline void cullRange(const float* bounds, size_t stride, const Frustum& frustum, uint8_t* visible, size_t count) {
+	for (size_t i=0; i<count; i+=V::W) {
+		unsigned mask = cull(bounds + i*stride, stride, frustum);
+		for (size_t k=0; k<V::W; k++) {visible[i + k] = static_cast<uint8_t>((mask >> k) & 1u);}
+	}
+}
+
+}
+
+#if defined(__clang__)
+	#pragma clang attribute pop
+#elif defined(__GNUC__)
+	#pragma GCC pop_options
+#endif
+
+#endif
+
+
+
+//Split [0, count) into contiguous chunks across threads, for batches big enough to be worth it.
+template<typename Func>
+inline void parallelFor(size_t count, size_t minPerThread, Func&& func) {
+	size_t threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), constants::misc::MAX_WORKER_THREADS);
+	threads = std::min(threads, std::max<size_t>(1u, count / minPerThread));
+	if (threads <= 1u) {func(0u, count); return;}
+
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1u);
+	size_t chunk = (count + threads - 1u) / threads;
+	for (size_t t=1; t<threads; t++) {
+		size_t begin = std::min(count, t * chunk), end = std::min(count, begin + chunk);
+		workers.emplace_back(func, begin, end);
+	}
+	func(0u, std::min(count, chunk));
+	for (std::thread& w : workers) {w.join();}
+}
+
+
+//visible[i] = 1 if object i (count × stride floats, see scalar::cull()) touches the frustum, else 0.
+inline void cull(const float* bounds, size_t count, size_t stride, const Frustum& frustum, uint8_t* visible) {
+	parallelFor(count, constants::misc::SIMD_MIN_PER_THREAD, [=, &frustum](size_t begin, size_t end) {
+		size_t i = begin;
+#ifdef GL_SIMD_X86
+		if (level == SIMD_AVX2) {
+			size_t whole = ((end - i) / avx2::V::W) * avx2::V::W;
+			avx2::cullRange(bounds + i*stride, stride, frustum, visible + i, whole);
+			i += whole;
+		}
+		if (level >= SIMD_SSE2) {
+			for (; i + sse2::V::W <= end; i += sse2::V::W) {
+				unsigned mask = sse2::cull(bounds + i*stride, stride, frustum);
+				for (size_t k=0; k<sse2::V::W; k++) {visible[i + k] = static_cast<uint8_t>((mask >> k) & 1u);}
+			}
+		}
+#endif
+		for (; i<end; i++) {visible[i] = static_cast<uint8_t>(scalar::cull(bounds + i*stride, stride, frustum));}
+	});
+}
+
+
+//count model matrices from (count,3) positions/rotations/scales, into count column-major 4x4s.
+inline void modelMatrices(const float* positions, const float* rotations, const float* scales, float* out, size_t count) {
+	parallelFor(count, constants::misc::SIMD_MIN_PER_THREAD, [=](size_t begin, size_t end) {
+		size_t i = begin;
+#ifdef GL_SIMD_X86
+		if (level == SIMD_AVX2) {
+			size_t whole = ((end - i) / avx2::V::W) * avx2::V::W;
+			avx2::modelMatricesRange(positions + i*3, rotations + i*3, scales + i*3, out + i*16, whole);
+			i += whole;
+		}
+		if (level >= SIMD_SSE2) {
+			for (; i + sse2::V::W <= end; i += sse2::V::W) {
+				sse2::modelMatrices(positions + i*3, rotations + i*3, scales + i*3, out + i*16);
+			}
+		}
+#endif
+		for (; i<end; i++) {scalar::modelMatrix(positions + i*3, rotations + i*3, scales + i*3, out + i*16);}
+	});
+}
+
+
+}
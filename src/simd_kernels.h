@@ -0,0 +1,137 @@
+//Batch kernels, written once against a vector type V (see simd.h).
+//No include guard: simd.h includes this once per instruction set, inside that set's namespace.
+//Everything here must only use V's operations, so each copy compiles for its own target.
+
+
+//Cephes-style sin/cos of every lane. Accurate to a few ulp for |x| < 8192, far beyond any sane angle.
+static inline void sincos(typename V::F x, typename V::F& s, typename V::F& c) {
+	using F = typename V::F;
+	using I = typename V::I;
+
+	const F signMask = V::castF(V::seti(static_cast<int>(0x80000000u)));
+	F signSin = V::and_(x, signMask);
+	x = V::andnot(signMask, x); //|x|
+
+	//Octant, rounded up to even.
+	I j = V::cvtt(V::mul(x, V::set1(1.27323954473516f))); //4/pi
+	j = V::andi(V::addi(j, V::seti(1)), V::seti(~1));
+	F y = V::cvt(j);
+
+	F swapSignSin = V::castF(V::slli29(V::andi(j, V::seti(4))));
+	F polyMask = V::castF(V::cmpeqi(V::andi(j, V::seti(2)), V::seti(0)));
+	F signCos = V::castF(V::slli29(V::andnoti(V::subi(j, V::seti(2)), V::seti(4))));
+	signSin = V::xor_(signSin, swapSignSin);
+
+	//Extended precision x - y*pi/4.
+	x = V::add(x, V::mul(y, V::set1(-0.78515625f)));
+	x = V::add(x, V::mul(y, V::set1(-2.4187564849853515625e-4f)));
+	x = V::add(x, V::mul(y, V::set1(-3.77489497744594108e-8f)));
+
+	F z = V::mul(x, x);
+	F cosPoly = V::set1(2.443315711809948e-5f);
+	cosPoly = V::add(V::mul(cosPoly, z), V::set1(-1.388731625493765e-3f));
+	cosPoly = V::add(V::mul(cosPoly, z), V::set1(4.166664568298827e-2f));
+	cosPoly = V::mul(V::mul(cosPoly, z), z);
+	cosPoly = V::add(V::sub(cosPoly, V::mul(z, V::set1(0.5f))), V::set1(1.0f));
+
+	F sinPoly = V::set1(-1.9515295891e-4f);
+	sinPoly = V::add(V::mul(sinPoly, z), V::set1(8.3321608736e-3f));
+	sinPoly = V::add(V::mul(sinPoly, z), V::set1(-1.6666654611e-1f));
+	sinPoly = V::add(V::mul(V::mul(sinPoly, z), x), x);
+
+	//Pick which polynomial is sin and which is cos for this octant.
+	F sinPart = V::and_(polyMask, sinPoly);
+	F cosPart = V::andnot(polyMask, cosPoly);
+	s = V::xor_(V::add(sinPart, cosPart), signSin);
+	c = V::xor_(V::add(V::sub(cosPoly, cosPart), V::sub(sinPoly, sinPart)), signCos);
+}
+
+
+//Model matrices of V::W objects, same maths as matrices::getModelMatrix() (rotation * scale * translation).
+//Inputs are (W,3) float arrays, output is W column-major 4x4 matrices.
+static inline void modelMatrices(const float* positions, const float* rotations, const float* scales, float* out) {
+	using F = typename V::F;
+
+	//(W,3) → one lane per object.
+	alignas(32) float soa[9][V::W];
+	for (size_t k=0; k<V::W; k++) {
+		for (size_t a=0; a<3; a++) {
+			soa[a][k] = positions[k*3 + a];
+			soa[3 + a][k] = rotations[k*3 + a];
+			soa[6 + a][k] = scales[k*3 + a];
+		}
+	}
+
+	F sx, cx, sy, cy, sz, cz;
+	sincos(V::load(soa[3]), sx, cx);
+	sincos(V::load(soa[4]), sy, cy);
+	sincos(V::load(soa[5]), sz, cz);
+	F scaleX = V::load(soa[6]), scaleY = V::load(soa[7]), scaleZ = V::load(soa[8]);
+
+	//Columns 0-2 are the rotation's columns times the scale, with the position in w. Column 3 is (0, 0, 0, 1).
+	F sxsy = V::mul(sx, sy);
+	F cxsy = V::mul(cx, sy);
+	V::storeColumn(out, 0,
+		V::mul(V::mul(cy, cz), scaleX),
+		V::mul(V::mul(cy, sz), scaleX),
+		V::mul(V::sub(V::set1(0.0f), sy), scaleX),
+		V::load(soa[0])
+	);
+	V::storeColumn(out, 1,
+		V::mul(V::sub(V::mul(sxsy, cz), V::mul(cx, sz)), scaleY),
+		V::mul(V::add(V::mul(sxsy, sz), V::mul(cx, cz)), scaleY),
+		V::mul(V::mul(sx, cy), scaleY),
+		V::load(soa[1])
+	);
+	V::storeColumn(out, 2,
+		V::mul(V::add(V::mul(cxsy, cz), V::mul(sx, sz)), scaleZ),
+		V::mul(V::sub(V::mul(cxsy, sz), V::mul(sx, cz)), scaleZ),
+		V::mul(V::mul(cx, cy), scaleZ),
+		V::load(soa[2])
+	);
+	F zero = V::set1(0.0f);
+	V::storeColumn(out, 3, zero, zero, zero, V::set1(1.0f));
+}
+
+
+//Frustum test of V::W spheres (stride 4) or AABBs (stride 6), see scalar::cull(). Bit k set = object k visible.
+static inline unsigned cull(const float* bounds, size_t stride, const Frustum& frustum) {
+	using F = typename V::F;
+
+	alignas(32) float soa[6][V::W];
+	for (size_t k=0; k<V::W; k++) {
+		for (size_t a=0; a<stride; a++) {soa[a][k] = bounds[k*stride + a];}
+	}
+
+	//Centre and how far the volume reaches along each axis (or radius, for spheres).
+	F centre[3], extent[3];
+	F radius = V::set1(0.0f);
+	if (stride == 4u) {
+		for (size_t a=0; a<3; a++) {centre[a] = V::load(soa[a]); extent[a] = V::set1(0.0f);}
+		radius = V::load(soa[3]);
+	} else {
+		F half = V::set1(0.5f);
+		for (size_t a=0; a<3; a++) {
+			F lo = V::load(soa[a]), hi = V::load(soa[3 + a]);
+			centre[a] = V::mul(V::add(lo, hi), half);
+			extent[a] = V::mul(V::sub(hi, lo), half);
+		}
+	}
+
+	unsigned visible = (1u << V::W) - 1u;
+	for (size_t p=0; p<6; p++) {
+		const float* plane = frustum.planes[p];
+		const float* absNormal = frustum.absNormals[p];
+		F distance = V::add(
+			V::add(V::mul(centre[0], V::set1(plane[0])), V::mul(centre[1], V::set1(plane[1]))),
+			V::add(V::mul(centre[2], V::set1(plane[2])), V::set1(plane[3]))
+		);
+		F reach = V::add(
+			V::add(radius, V::mul(extent[0], V::set1(absNormal[0]))),
+			V::add(V::mul(extent[1], V::set1(absNormal[1])), V::mul(extent[2], V::set1(absNormal[2])))
+		);
+		visible &= V::movemask(V::cmpge(V::add(distance, reach), V::set1(0.0f)));
+		if (!visible) {break;}
+	}
+	return visible;
+}
@@ -0,0 +1,264 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+
+
+
+//Shadow copy of the GL state this module touches.
+//Every state change goes through here; it only reaches the driver when the value actually changes.
+//Anything unknown (after init, or changed behind the cache's back) is marked UNKNOWN so the next set is issued.
+namespace glstate {
+
+
+constexpr GLuint UNKNOWN = ~0u;
+
+
+//Calls issued to/skipped before the driver.
+struct Stats {
+	uint64_t issued = 0u;
+	uint64_t skipped = 0u;
+};
+
+inline Stats frame; //Current frame, so far.
+inline Stats lastFrame; //Last complete frame.
+
+
+enum Capability {
+	CAP_BLEND,
+	CAP_DEPTH_TEST,
+	CAP_CULL_FACE,
+	CAP_COUNT
+};
+constexpr std::array<GLenum, CAP_COUNT> capabilityEnums = {GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE};
+
+
+struct ImageUnit {
+	GLuint texture = UNKNOWN;
+	GLenum access = 0u;
+	GLenum format = 0u;
+};
+
+
+inline std::array<GLuint, CAP_COUNT> capabilities; //0/1, or UNKNOWN
+inline GLuint depthFunc = UNKNOWN;
+inline GLuint depthMask = UNKNOWN;
+inline float clearDepth = -1.0f; //Valid range is [0, 1], so negative is unknown.
+inline GLuint program = UNKNOWN;
+inline GLuint vertexArray = UNKNOWN;
+inline GLuint framebuffer = UNKNOWN;
+inline glm::ivec4 viewport = glm::ivec4(-1);
+inline std::array<GLuint, constants::misc::MAX_TEXTURE_UNITS> textureUnits;
+inline std::array<ImageUnit, constants::misc::MAX_TEXTURE_UNITS> imageUnits;
+
+
+//Returns true (and counts it) if the call must reach the driver.
+inline bool changed(bool differs) {
+	if (differs) {frame.issued++;} else {frame.skipped++;}
+	return differs;
+}
+
+
+
+inline void setCapability(Capability cap, bool enabled) {
+	GLuint value = (enabled) ? 1u : 0u;
+	if (!changed(capabilities[cap] != value)) {return;}
+	if (enabled) {glEnable(capabilityEnums[cap]);} else {glDisable(capabilityEnums[cap]);}
+	capabilities[cap] = value;
+}
+
+inline void setDepthFunc(GLenum func) {
+	if (!changed(depthFunc != func)) {return;}
+	glDepthFunc(func);
+	depthFunc = func;
+}
+
+inline void setDepthMask(bool write) {
+	GLuint value = (write) ? GL_TRUE : GL_FALSE;
+	if (!changed(depthMask != value)) {return;}
+	glDepthMask(static_cast<GLboolean>(value));
+	depthMask = value;
+}
+
+inline void setClearDepth(float depth) {
+	if (!changed(clearDepth != depth)) {return;}
+	glClearDepth(depth);
+	clearDepth = depth;
+}
+
+
+inline void useProgram(GLuint ID) {
+	if (!changed(program != ID)) {return;}
+	glUseProgram(ID);
+	program = ID;
+}
+
+inline void bindVertexArray(GLuint ID) {
+	if (!changed(vertexArray != ID)) {return;}
+	glBindVertexArray(ID);
+	vertexArray = ID;
+}
+
+inline void bindFramebuffer(GLuint ID) {
+	if (!changed(framebuffer != ID)) {return;}
+	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+	framebuffer = ID;
+}
+
+inline void setViewport(glm::ivec2 size) {
+	glm::ivec4 value = glm::ivec4(0, 0, size.x, size.y);
+	if (!changed(viewport != value)) {return;}
+	glViewport(0, 0, size.x, size.y);
+	viewport = value;
+}
+
+
+inline void bindTextureUnit(GLuint unit, GLuint texture) {
+	if (unit >= textureUnits.size()) {glBindTextureUnit(unit, texture); frame.issued++; return; /* Not tracked. */}
+	if (!changed(textureUnits[unit] != texture)) {return;}
+	glBindTextureUnit(unit, texture);
+	textureUnits[unit] = texture;
+}
+
+inline void bindImageTexture(GLuint unit, GLuint texture, GLenum access, GLenum format) {
+	if (unit >= imageUnits.size()) {
+		glBindImageTexture(unit, texture, 0, GL_FALSE, 0, access, format);
+		frame.issued++;
+		return; /* Not tracked. */
+	}
+	ImageUnit& current = imageUnits[unit];
+	if (!changed((current.texture != texture) || (current.access != access) || (current.format != format))) {return;}
+	glBindImageTexture(unit, texture, 0, GL_FALSE, 0, access, format);
+	current = ImageUnit{texture, access, format};
+}
+
+
+
+//Batched binds, for a whole shader's worth of units at once.
+//Entries must be sorted by unit. Each run of consecutive units is bound in one glBindTextures/glBindImageTextures
+//call if any unit in it changed, or skipped entirely if none did.
+struct TextureBind {
+	GLuint unit;
+	GLuint texture;
+};
+
+struct ImageBind {
+	GLuint unit;
+	GLuint texture;
+	GLenum access;
+	GLenum format;
+};
+
+
+inline void bindTextureUnits(const TextureBind* binds, size_t count) {
+	std::array<GLuint, constants::misc::MAX_TEXTURE_UNITS> names;
+
+	size_t i = 0u;
+	while (i < count) {
+		if (binds[i].unit >= textureUnits.size()) {bindTextureUnit(binds[i].unit, binds[i].texture); i++; continue;}
+
+		//Gather the run of consecutive, tracked units.
+		GLuint first = binds[i].unit;
+		size_t n = 0u;
+		bool differs = false;
+		while ((i + n < count) && (binds[i + n].unit == first + n) && (binds[i + n].unit < textureUnits.size())) {
+			names[n] = binds[i + n].texture;
+			differs |= (textureUnits[first + n] != names[n]);
+			n++;
+		}
+
+		if (differs) {
+			if (n == 1u) {glBindTextureUnit(first, names[0]);}
+			else {glBindTextures(first, static_cast<GLsizei>(n), names.data());}
+			std::copy(names.begin(), names.begin() + n, textureUnits.begin() + first);
+			frame.issued++;
+		} else {
+			frame.skipped += n;
+		}
+		i += n;
+	}
+}
+
+
+//glBindImageTextures can only bind GL_READ_WRITE with the texture's own format, anything else is bound singly.
+inline void bindImageUnits(const ImageBind* binds, size_t count) {
+	std::array<GLuint, constants::misc::MAX_TEXTURE_UNITS> names;
+
+	size_t i = 0u;
+	while (i < count) {
+		const ImageBind& b = binds[i];
+		if ((b.unit >= imageUnits.size()) || (b.access != GL_READ_WRITE)) {bindImageTexture(b.unit, b.texture, b.access, b.format); i++; continue;}
+
+		GLuint first = b.unit;
+		size_t n = 0u;
+		bool differs = false;
+		while ((i + n < count) && (binds[i + n].unit == first + n) && (binds[i + n].unit < imageUnits.size()) && (binds[i + n].access == GL_READ_WRITE)) {
+			const ImageBind& next = binds[i + n];
+			const ImageUnit& current = imageUnits[next.unit];
+			names[n] = next.texture;
+			differs |= (current.texture != next.texture) || (current.access != next.access) || (current.format != next.format);
+			n++;
+		}
+
+		if (differs) {
+			if (n == 1u) {glBindImageTexture(first, names[0], 0, GL_FALSE, 0, GL_READ_WRITE, b.format);}
+			else {glBindImageTextures(first, static_cast<GLsizei>(n), names.data());}
+			for (size_t j=0; j<n; j++) {imageUnits[first + j] = ImageUnit{binds[i + j].texture, GL_READ_WRITE, binds[i + j].format};}
+			frame.issued++;
+		} else {
+			frame.skipped += n;
+		}
+		i += n;
+	}
+}
+
+
+
+//Something changed this unit without the cache, e.g. a non-DSA glBindTexture.
+inline void invalidateTextureUnit(GLuint unit) {
+	if (unit < textureUnits.size()) {textureUnits[unit] = UNKNOWN;}
+}
+
+//Deleting objects unbinds them (GL reverts those bindings to 0), and their names may be reused.
+inline void forgetTexture(GLuint texture) {
+	for (GLuint& t : textureUnits) {if (t == texture) {t = 0u;}}
+	for (ImageUnit& i : imageUnits) {if (i.texture == texture) {i.texture = 0u;}}
+}
+
+inline void forgetProgram(GLuint ID) {
+	if (program == ID) {program = UNKNOWN; /* Stays in use until replaced, but the name can't be trusted. */}
+}
+
+inline void forgetFramebuffer(GLuint ID) {
+	if (framebuffer == ID) {framebuffer = 0u;}
+}
+
+inline void forgetVertexArray(GLuint ID) {
+	if (vertexArray == ID) {vertexArray = 0u;}
+}
+
+
+//Call once per frame, in gl.update_window().
+inline void endFrame() {
+	lastFrame = frame;
+	frame = Stats();
+}
+
+
+//Forget everything, e.g. for a new context.
+inline void reset() {
+	capabilities.fill(UNKNOWN);
+	depthFunc = UNKNOWN;
+	depthMask = UNKNOWN;
+	clearDepth = -1.0f;
+	program = UNKNOWN;
+	vertexArray = UNKNOWN;
+	framebuffer = UNKNOWN;
+	viewport = glm::ivec4(-1);
+	textureUnits.fill(UNKNOWN);
+	imageUnits.fill(ImageUnit());
+	frame = Stats();
+	lastFrame = Stats();
+}
+
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+#include "utils.h"
+#include "profiler.h"
+
+
+
+//GPU timing of shader runs.
+//Each shader gets a small ring of GL_TIMESTAMP query pairs. Results are only read once the driver
+//says they are available (usually a few frames later), so timing never stalls the pipeline.
+namespace timing {
+
+
+//Summary of the recent GPU times of one shader, in microseconds.
+struct GPUStats {
+	size_t samples = 0u;
+	double mean = 0.0;
+	double min = 0.0;
+	double max = 0.0;
+	double p95 = 0.0;
+};
+
+
+class GPUTimer {
+private:
+	static constexpr size_t RING = constants::misc::GPU_TIMER_RING;
+	static constexpr size_t WINDOW = constants::misc::GPU_TIMER_SAMPLES;
+
+	std::array<GLuint, RING * 2u> _queries = {}; //Start & end timestamp per slot
+	std::array<bool, RING> _inFlight = {};
+	size_t _next = 0u;
+	bool _created = false;
+	bool _timing = false; //Is the current run being timed?
+	int _owner = -1; //Shader ID, for profiler events.
+
+	std::array<double, WINDOW> _samples = {}; //Rolling window of durations [us]
+	size_t _sampleHead = 0u;
+	size_t _sampleCount = 0u;
+
+
+	void push(double us) {
+		_samples[_sampleHead] = us;
+		_sampleHead = (_sampleHead + 1u) % WINDOW;
+		_sampleCount = std::min(_sampleCount + 1u, WINDOW);
+	}
+
+	//Read one slot if the driver has finished it. Never waits.
+	bool collectSlot(size_t slot) {
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(_queries[slot*2u + 1u], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {return false;}
+
+		GLuint64 start = 0u, end = 0u;
+		glGetQueryObjectui64v(_queries[slot*2u], GL_QUERY_RESULT, &start);
+		glGetQueryObjectui64v(_queries[slot*2u + 1u], GL_QUERY_RESULT, &end);
+		push(static_cast<double>(end - start) / 1000.0); //ns → us
+		profiler::gpuEvent(_owner, start, end);
+
+		_inFlight[slot] = false;
+		return true;
+	}
+
+public:
+	//Read every finished slot.
+	void collect() {
+		if (!_created) {return;}
+		for (size_t slot=0; slot<RING; slot++) {
+			if (_inFlight[slot]) {collectSlot(slot);}
+		}
+	}
+
+
+	void begin(int shaderID) {
+		_owner = shaderID;
+		if (!_created) {
+			glGenQueries(static_cast<GLsizei>(_queries.size()), _queries.data());
+			_created = true;
+		}
+
+		//Ring is full and the oldest isn't back yet; skip timing this run rather than stall.
+		_timing = !_inFlight[_next] || collectSlot(_next);
+		if (_timing) {glQueryCounter(_queries[_next*2u], GL_TIMESTAMP);}
+	}
+
+	void end() {
+		if (!_timing) {return;}
+		glQueryCounter(_queries[_next*2u + 1u], GL_TIMESTAMP);
+		_inFlight[_next] = true;
+		_next = (_next + 1u) % RING;
+		_timing = false;
+	}
+
+
+	GPUStats stats() const {
+		GPUStats out;
+		out.samples = _sampleCount;
+		if (_sampleCount == 0u) {return out;}
+
+		std::vector<double> sorted(_samples.begin(), _samples.begin() + _sampleCount);
+		std::sort(sorted.begin(), sorted.end());
+
+		double total = 0.0;
+		for (double s : sorted) {total += s;}
+		out.mean = total / static_cast<double>(_sampleCount);
+		out.min = sorted.front();
+		out.max = sorted.back();
+		out.p95 = sorted[std::min(_sampleCount - 1u, (_sampleCount * 95u) / 100u)];
+		return out;
+	}
+
+	bool hasSamples() const {return _sampleCount > 0u;}
+
+
+	//Deletion
+	void destroy() {
+		if (_created) {glDeleteQueries(static_cast<GLsizei>(_queries.size()), _queries.data());}
+		_queries = {};
+		_inFlight = {};
+		_next = 0u;
+		_created = false;
+		_timing = false;
+		_owner = -1;
+		_sampleHead = 0u;
+		_sampleCount = 0u;
+	}
+};
+
+
+inline bool gpuEnabled = false;
+inline std::array<GPUTimer, constants::misc::MAX_SHADERS> shaderTimers; //Indexed by shader ID
+
+
+//Free all query objects. Must be called while the context still exists.
+inline void reset() {
+	for (GPUTimer& t : shaderTimers) {t.destroy();}
+}
+
+
+}
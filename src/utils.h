@@ -16,39 +16,6 @@ static bool verbosityAllowed(Verbosity vLevel) {
 namespace utils {
 
 
-//Default cout defs
-template<typename... Args>
-static inline void cout_inline(Args&&... args) {
-	if (shared::verbose == V_SILENT) {return; /* Don't output to console. */}
-	((std::cout << args << " "), ...); //Requires C++17 or more.
-	std::cout << std::flush;
-}
-template<typename... Args>
-static inline void cout(Args&&... args) {
-	if (shared::verbose == V_SILENT) {return; /* Don't output to console. */}
-	std::cout << "[C++] ";
-	((std::cout << args << " "), ...); //Requires C++17 or more.
-	std::cout << std::endl;
-}
-
-
-//Custom verbosity level overload defs
-template<typename... Args>
-static inline void cout_inline(Verbosity vLevel, Args&&... args) {
-	if (!verbosityAllowed(vLevel)) {return; /* Don't output to console. */}
-	((std::cout << args << " "), ...); //Requires C++17 or more.
-	std::cout << std::flush;
-}
-template<typename... Args>
-static inline void cout(Verbosity vLevel, Args&&... args) {
-	if (!verbosityAllowed(vLevel)) {return; /* Don't output to console. */}
-	std::cout << "[C++] ";
-	((std::cout << args << " "), ...); //Requires C++17 or more.
-	std::cout << std::endl;
-}
-
-
-
 template<typename... Args>
 static inline void cerr(Args&&... args) {
 	//Concatenate
@@ -62,17 +29,11 @@ static inline void cerr(Args&&... args) {
 
 
 
-static inline void pause() {
-	std::string pause;
-	std::cin >> pause;
-}
-
-static inline void GLErrorcheck(std::string location="", bool shouldPause=false) {
+static inline void GLErrorcheck(std::string location="") {
 	GLenum GLError;
 	GLError = glGetError();
 	if (GLError != GL_NO_ERROR) {
 		utils::cerr(location, " | OpenGL error; ", GLError, "\n");
-		if (shouldPause) {pause();}
 	}
 }
 
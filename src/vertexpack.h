@@ -0,0 +1,196 @@
+#pragma once
+#include "includes.h"
+#include "constants.h"
+#include "utils.h"
+#include "simd.h"
+
+#include <atomic>
+#include <limits>
+
+
+
+//Vertex & index buffer layouts.
+//VAOFormats are packed from float32 into smaller GPU formats once before upload. Attributes each start on a 4 byte
+//boundary (so the vertex stride is a multiple of 4), and the shader still reads plain vec2/vec3s whatever the storage.
+//User-defined layouts describe buffers as they are, read from one or more streams (vertex buffer bindings).
+namespace vertexpack {
+
+
+constexpr float HALF_MAX = 65504.0f; //Largest finite half float
+
+
+//One attribute as stored on the GPU, as glVertexArrayAttrib(I)Format() takes it.
+struct AttributeFormat {
+	GLuint location = 0u;             //layout(location=N) in the vertex shader
+	GLint components = 0;             //Floats read from each input vertex, when packing
+	GLint size = 0;                   //Components GL reads, 4 for the 2_10_10_10 types
+	GLenum type = GL_FLOAT;
+	GLboolean normalized = GL_FALSE;
+	GLuint offset = 0u;               //Bytes into the stream's vertex
+	GLuint stream = 0u;               //Vertex buffer binding it reads from
+	bool integer = false;             //Read as an int/uint in the shader, not converted to float
+};
+
+//One vertex buffer's contents, borrowed. Vertex i starts at data + i*stride.
+struct VertexStream {
+	const void* data = nullptr;
+	size_t bytes = 0u;
+	GLuint stride = 0u;
+};
+
+struct Layout {
+	std::vector<AttributeFormat> attributes;
+	GLuint stride = 0u; //Bytes per vertex
+};
+
+
+inline AttributeFormat formatOf(const Attribute& attr, VertexPacking packing) {
+	AttributeFormat out;
+	out.components = out.size = attr.size;
+	if (packing == VP_FLOAT) {return out;}
+
+	if (attr.kind != AK_NORMAL) {out.type = GL_HALF_FLOAT; return out;}
+	out.normalized = GL_TRUE;
+	if (packing == VP_HALF) {out.type = GL_SHORT;}
+	else {out.type = GL_INT_2_10_10_10_REV; out.size = 4; /* Only valid as 4 components, w is left 0. */}
+	return out;
+}
+
+
+inline GLuint bytesOf(const AttributeFormat& attr) {
+	switch (attr.type) {
+		case GL_BYTE: case GL_UNSIGNED_BYTE: {return 1u * attr.size;}
+		case GL_HALF_FLOAT: case GL_SHORT: case GL_UNSIGNED_SHORT: {return 2u * attr.size;}
+		case GL_INT_2_10_10_10_REV: case GL_UNSIGNED_INT_2_10_10_10_REV: {return 4u;}
+		default: {return 4u * attr.size; /* GL_FLOAT, GL_INT, GL_UNSIGNED_INT */}
+	}
+}
+
+
+//Byte layout of a VAOFormat's vertex under a packing.
+inline Layout layoutOf(VAOFormat format, VertexPacking packing) {
+	Layout out;
+	for (const Attribute& attr : constants::display::layouts.at(format)) {
+		AttributeFormat packed = formatOf(attr, packing);
+		packed.location = static_cast<GLuint>(out.attributes.size());
+		packed.offset = out.stride;
+		out.stride += (bytesOf(packed) + 3u) & ~3u;
+		out.attributes.push_back(packed);
+	}
+	return out;
+}
+
+
+
+//Encode count float32 vertices (floatsPerVertex each) into layout's bytes. Raises if a half float would overflow.
+inline std::vector<uint8_t> packVertices(const std::vector<float>& vertices, size_t floatsPerVertex, const Layout& layout) {
+	size_t count = vertices.size() / floatsPerVertex;
+	std::vector<uint8_t> out(count * layout.stride, 0u);
+	std::atomic<bool> overflow = false;
+
+	simd::parallelFor(count, constants::misc::SIMD_MIN_PER_THREAD, [&](size_t begin, size_t end) {
+		bool localOverflow = false;
+		for (size_t v=begin; v<end; v++) {
+			const float* in = vertices.data() + v*floatsPerVertex;
+			uint8_t* vertex = out.data() + v*layout.stride;
+
+			for (const AttributeFormat& attr : layout.attributes) {
+				uint8_t* dst = vertex + attr.offset;
+				switch (attr.type) {
+					case GL_HALF_FLOAT: {
+						for (GLint k=0; k<attr.components; k++) {
+							localOverflow |= (std::abs(in[k]) > HALF_MAX);
+							uint16_t h = glm::packHalf1x16(in[k]);
+							std::memcpy(dst + 2*k, &h, sizeof(h));
+						}
+						break;
+					}
+					case GL_SHORT: {
+						for (GLint k=0; k<attr.components; k++) {
+							uint16_t s = glm::packSnorm1x16(in[k]);
+							std::memcpy(dst + 2*k, &s, sizeof(s));
+						}
+						break;
+					}
+					case GL_INT_2_10_10_10_REV: {
+						uint32_t p = glm::packSnorm3x10_1x2(glm::vec4(in[0], in[1], in[2], 0.0f));
+						std::memcpy(dst, &p, sizeof(p));
+						break;
+					}
+					default: {std::memcpy(dst, in, attr.components * sizeof(float)); break;}
+				}
+				in += attr.components;
+			}
+		}
+		if (localOverflow) {overflow = true;}
+	});
+
+	if (overflow) {utils::cerr(std::format("A position or UV is beyond +-{} and can't be stored as a half float, use gl.PACK_FLOAT", HALF_MAX));}
+	return out;
+}
+
+
+
+//16 bit indices whenever every vertex fits in them, halving index fetch.
+inline GLenum indexType(size_t vertexCount) {
+	return (vertexCount <= (size_t(std::numeric_limits<uint16_t>::max()) + 1u)) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+inline size_t indexBytes(GLenum type) {return (type == GL_UNSIGNED_SHORT) ? sizeof(uint16_t) : sizeof(GLuint);}
+
+
+//Raises if any index is past the vertices given, which would otherwise read whatever follows in GPU memory.
+inline void checkIndices(const std::vector<GLuint>& indices, size_t vertexCount) {
+	GLuint highest = 0u;
+	for (GLuint index : indices) {highest = std::max(highest, index);}
+	if (!indices.empty() && (highest >= vertexCount)) {
+		utils::cerr(std::format("Index [{}] is past the [{}] vertices given", highest, vertexCount));
+	}
+}
+
+
+inline std::vector<uint16_t> narrowIndices(const std::vector<GLuint>& indices) {
+	return std::vector<uint16_t>(indices.begin(), indices.end());
+}
+
+
+
+//Raises unless every attribute is valid for GL and inside its stream's vertex. Returns the vertex count, which every stream must share.
+inline size_t checkLayout(const std::vector<AttributeFormat>& attributes, const std::vector<VertexStream>& streams, GLuint maxAttributes) {
+	if (streams.empty()) {utils::cerr("A vertex layout needs at least one stream of vertices");}
+	size_t vertexCount = 0u;
+	for (size_t s=0; s<streams.size(); s++) {
+		const VertexStream& stream = streams[s];
+		if ((stream.stride == 0u) || ((stream.bytes % stream.stride) != 0u)) {
+			utils::cerr(std::format("Stream [{}] has [{}] bytes, not a whole number of [{}] byte vertices", s, stream.bytes, stream.stride));
+		}
+		size_t count = stream.bytes / stream.stride;
+		if ((s > 0u) && (count != vertexCount)) {
+			utils::cerr(std::format("Stream [{}] has [{}] vertices but stream 0 has [{}], every stream needs one entry per vertex", s, count, vertexCount));
+		}
+		vertexCount = count;
+	}
+
+	std::set<GLuint> locations;
+	for (const AttributeFormat& attr : attributes) {
+		bool packed = (attr.type == GL_INT_2_10_10_10_REV) || (attr.type == GL_UNSIGNED_INT_2_10_10_10_REV);
+		bool integerType = !packed && (attr.type != GL_FLOAT) && (attr.type != GL_HALF_FLOAT);
+		if (attr.location >= maxAttributes) {utils::cerr(std::format("Attribute location [{}] is past this GPU's [{}] attributes", attr.location, maxAttributes));}
+		if (!locations.insert(attr.location).second) {utils::cerr(std::format("Attribute location [{}] is used twice", attr.location));}
+		if ((attr.size < 1) || (attr.size > 4) || (packed && (attr.size != 4))) {
+			utils::cerr(std::format("Attribute [{}] has [{}] components, must be 1-4 (4 for 2_10_10_10 types)", attr.location, attr.size));
+		}
+		if (attr.integer && !integerType) {utils::cerr(std::format("Attribute [{}] is read as an integer, but isn't stored as one", attr.location));}
+		if (attr.stream >= streams.size()) {utils::cerr(std::format("Attribute [{}] reads stream [{}], but only [{}] were given", attr.location, attr.stream, streams.size()));}
+		if ((attr.offset + bytesOf(attr)) > streams[attr.stream].stride) {
+			utils::cerr(std::format(
+				"Attribute [{}] spans bytes [{} - {}], past stream [{}]'s [{}] byte vertex",
+				attr.location, attr.offset, attr.offset + bytesOf(attr), attr.stream, streams[attr.stream].stride
+			));
+		}
+	}
+	return vertexCount;
+}
+
+
+}
@@ -1,6 +1,11 @@
 "test.py"
 #Used to test the module.
 
+import os;
+import json;
+import struct;
+import tempfile;
+import numpy as np;
 import glm;
 import gl;
 
@@ -19,6 +24,8 @@ class Colours:
 ######## ANSI COLOURS ########
 
 
+#Files the tests write, removed once they finish.
+outputs:tempfile.TemporaryDirectory = tempfile.TemporaryDirectory(prefix="gl_test_");
 
 
 
@@ -35,19 +42,19 @@ cam:dict[str, glm.vec3] = {
 CURSOR_SPEED:float = 0.0025;
 MOVE_SPEED:float = 0.1;
 
-def updateCamera(cameraID:int) -> None:
-	#Get cursor & keyboard inputs and upd the camera.
+def updateCamera(cameraID:int, inputs:dict) -> None:
+	#Get cursor & keyboard inputs (from gl.input_snapshot()) and upd the camera.
 	forward:glm.vec3 = glm.vec3(gl.get_camera_direction(cameraID, gl.FORWARD));
 	right:glm.vec3 = glm.vec3(gl.get_camera_direction(cameraID, gl.RIGHT));
 	up:glm.vec3 = glm.vec3(gl.get_camera_direction(cameraID, gl.UP));
 	fb:int = 0; lr:int = 0; ud:int = 0;
 
-	if (gl.is_key_held(gl.KEY_W)): fb += 1;
-	if (gl.is_key_held(gl.KEY_S)): fb -= 1;
-	if (gl.is_key_held(gl.KEY_D)): lr += 1;
-	if (gl.is_key_held(gl.KEY_A)): lr -= 1;
-	if (gl.is_key_held(gl.KEY_E)): ud += 1;
-	if (gl.is_key_held(gl.KEY_Q)): ud -= 1;
+	if (inputs["held"][gl.KEY_W]): fb += 1;
+	if (inputs["held"][gl.KEY_S]): fb -= 1;
+	if (inputs["held"][gl.KEY_D]): lr += 1;
+	if (inputs["held"][gl.KEY_A]): lr -= 1;
+	if (inputs["held"][gl.KEY_E]): ud += 1;
+	if (inputs["held"][gl.KEY_Q]): ud -= 1;
 
 
 	cam["position"] += forward * MOVE_SPEED * fb;
@@ -55,10 +62,10 @@ def updateCamera(cameraID:int) -> None:
 	cam["position"] += up * MOVE_SPEED * ud;
 
 
-	if (gl.is_key_held(gl.KEY_1)): gl.show_cursor();
+	if (inputs["held"][gl.KEY_1]): gl.show_cursor();
 	else:
 		gl.hide_cursor();
-		cursorDelta:glm.vec2 = glm.vec2(gl.get_cursor_movement());
+		cursorDelta:glm.vec2 = glm.vec2(*inputs["cursor_delta"]);
 		delta:glm.vec3 = glm.vec3(cursorDelta.x, -cursorDelta.y, 0.0);
 		cam["angle"] += delta * CURSOR_SPEED;
 
@@ -103,13 +110,15 @@ def doExample3D() -> None:
 	modlMat:glm.mat4 = glm.mat4(gl.get_matrix(gl.IDENTITY)); #Identity for now.
 
 
+	gl.set_swap_interval(1);
 	gl.set_output(gl.SILENT);
-	while (gl.is_window_open() and (not gl.is_key_held(gl.KEY_ESCAPE))): #Example Main program loop.
+	inputs:dict = gl.input_snapshot(); #Views, refreshed by every gl.poll_events().
+	while (gl.is_window_open() and (not inputs["held"][gl.KEY_ESCAPE])): #Example Main program loop.
 		gl.poll_events(); #Look for events
 
 		#Run stages of frame
 		#Update the camera
-		updateCamera(cameraID);
+		updateCamera(cameraID, inputs);
 
 		#Matrix creation
 		viewMat:glm.mat4 = glm.mat4(gl.get_matrix(gl.VIEW, cameraID));
@@ -120,7 +129,8 @@ def doExample3D() -> None:
 
 		gl.update_window(); #Update the screen with the next frame.
 
-
+	print(f"{Colours.VALUE}[PY ] Frame stats: {gl.frame_stats()}{Colours.MINOR}");
+	print(f"{Colours.VALUE}[PY ] State changes: {gl.get_state_stats()}{Colours.MINOR}");
 	gl.delete_camera(cameraID);
 	gl.delete_texture(textureID);
 	gl.terminate(); #Close after.
@@ -156,6 +166,15 @@ def screenspaceShader() -> None:
 	assert successRun, "Failed to run Screenspace Shader.";
 	gl.update_window();
 
+	#Render into a texture instead of the screen.
+	targetTex:int = gl.create_texture(glm.ivec2(256, 256));
+	fbID:int = gl.create_framebuffer([targetTex], depth=False);
+	assert (fbID != -1), "Failed to create framebuffer";
+	gl.clear_framebuffer(fbID);
+	successTarget:bool = gl.run(shaderID, target=fbID);
+	assert successTarget, "Failed to run Screenspace Shader into a framebuffer.";
+	gl.delete_framebuffer(fbID);
+
 
 	print(f"{Colours.SUCCESS}[PY ] Screenspace Shader Tests Passed{Colours.MINOR}");
 
@@ -179,8 +198,38 @@ def computeShader() -> None:
 	success0:bool = gl.run(shaderID, [0, 0, 0]);
 	assert success0, "Failed to run Compute Shader [0, 0, 0].";
 
-
-	print(f"{Colours.SUCCESS}[PY ] Compute Shader Tests Passed{Colours.MINOR}");
+	#Test GPU timing of runs
+	gl.enable_gpu_timing(True);
+	for _ in range(8): gl.run(shaderID, [16, 16, 16]);
+	gl.enable_gpu_timing(False);
+	timings:dict = gl.get_gpu_timings();
+	print(f"{Colours.VALUE}[PY ] GPU timings: {timings}{Colours.MINOR}");
+
+	#Verified barriers: binding 1 isn't qualified in the source (so read-write), but added read-only the tracker
+	#wouldn't synchronise the second run's writes after the first run's reads.
+	cellID:int = gl.load_shader(gl.COMPUTE, compute="shaders/cell.example.comp");
+	grid:int = gl.create_texture(glm.ivec2(64, 64));
+	gl.set_barrier_mode(gl.BARRIER_VERIFY);
+	gl.add_texture(cellID, grid, 1, access=gl.READ);
+	assert gl.run(cellID, [64, 64, 1]), "Failed to run a verified Compute Shader.";
+	try:
+		gl.run(cellID, [64, 64, 1]);
+		raise AssertionError("An unsynchronised write after read wasn't caught");
+	except RuntimeError:
+		pass;
+	gl.set_barrier_mode(gl.BARRIER_TRACKED);
+
+	#Ping-pong: every run after the first reads & writes what the run before it wrote, so each needs a barrier.
+	pingPong:int = gl.create_texture_pair(gl.create_texture(glm.ivec2(64, 64)), gl.create_texture(glm.ivec2(64, 64)));
+	gl.add_texture_pair(cellID, pingPong, 1, gl.FRONT);
+	gl.add_texture_pair(cellID, pingPong, 2, gl.BACK);
+	assert gl.run(cellID, [64, 64, 1]), "Failed to run a Compute Shader on a texture pair.";
+	for i in range(3):
+		gl.swap(pingPong);
+		issued:int = gl.get_barrier_count();
+		assert gl.run(cellID, [64, 64, 1]), "Failed to run a Compute Shader on a swapped texture pair.";
+		assert (gl.get_barrier_count() == issued + 1), f"Ping-pong run [{i + 2}] didn't issue a barrier";
+	gl.delete_texture_pair(pingPong);
 
 
 ########            ########
@@ -222,6 +271,133 @@ def worldspaceShader(cameraID:int) -> None:
 	gl.update_window();
 
 
+	#Load a cube from an OBJ instead; 6 quads sharing 8 corners (each with 1 of 2 UVs) → 12 triangles.
+	print(f"{Colours.MAJOR}[PY ] Testing mesh loading{Colours.MINOR}");
+	objPath:str = os.path.join(outputs.name, "test.out.obj");
+	with open(objPath, "w") as obj:
+		obj.write("".join(f"v {x} {y} {z}\n" for z in (-1, 1) for y in (-1, 1) for x in (-1, 1)));
+		obj.write("vt 0 0\nvt 1 1\n");
+		for face in ((1, 2, 4, 3), (5, 6, 8, 7), (1, 2, 6, 5), (3, 4, 8, 7), (1, 3, 7, 5), (2, 4, 8, 6)):
+			obj.write("f " + " ".join(f"{v}/{1 + (v % 2)}" for v in face) + "\n");
+	mesh:dict = gl.load_mesh(shaderID, objPath);
+	assert (mesh["format"] == gl.POS_UV2D) and (mesh["vertices"] == 8) and (mesh["indices"] == 36), f"Mesh loaded wrong: {mesh}";
+	assert (tuple(mesh["bounds_min"]) == (-1.0, -1.0, -1.0)) and (tuple(mesh["bounds_max"]) == (1.0, 1.0, 1.0)), "Mesh bounds are wrong";
+	assert gl.run(shaderID), "Failed to run Worldspace Shader with a loaded mesh.";
+	gl.update_window();
+
+	#And from a .glb: an indexed quad & an unindexed triangle, both with UVs & normals → 7 vertices, 9 indices.
+	glbPath:str = os.path.join(outputs.name, "test.out.glb");
+	binary:bytearray = bytearray();
+	views:list[dict] = [];
+	accessors:list[dict] = [];
+	def addAccessor(rows:list, kind:str, componentType:int, code:str) -> int:
+		flat:list = [value for row in rows for value in (row if isinstance(row, tuple) else (row,))];
+		data:bytes = struct.pack(f"<{len(flat)}{code}", *flat);
+		views.append({"buffer": 0, "byteOffset": len(binary), "byteLength": len(data)});
+		binary.extend(data + b"\0" * (-len(data) % 4));
+		accessors.append({"bufferView": len(views) - 1, "componentType": componentType, "count": len(rows), "type": kind});
+		return len(accessors) - 1;
+	primitives:list[dict] = [];
+	for positions, uvs, indices in (
+		([(0.0, 0.0, 0.0), (1.0, 0.0, 0.0), (1.0, 1.0, 0.0), (0.0, 1.0, 0.0)], [(0.0, 0.0), (1.0, 0.0), (1.0, 1.0), (0.0, 1.0)], [0, 1, 2, 0, 2, 3]),
+		([(0.0, 0.0, -1.0), (2.0, 0.0, -1.0), (0.0, 3.0, -1.0)], [(0.0, 0.0), (1.0, 0.0), (0.0, 1.0)], None),
+	):
+		attributes:dict = {
+			"POSITION": addAccessor(positions, "VEC3", 5126, "f"),
+			"TEXCOORD_0": addAccessor(uvs, "VEC2", 5126, "f"),
+			"NORMAL": addAccessor([(0.0, 0.0, 1.0)] * len(positions), "VEC3", 5126, "f"),
+		};
+		primitives.append({"attributes": attributes} if (indices is None) else {"attributes": attributes, "indices": addAccessor(indices, "SCALAR", 5123, "H")});
+	gltf:bytes = json.dumps({"asset": {"version": "2.0"}, "buffers": [{"byteLength": len(binary)}], "bufferViews": views, "accessors": accessors, "meshes": [{"primitives": primitives}]}).encode();
+	gltf += b" " * (-len(gltf) % 4);
+	with open(glbPath, "wb") as glb:
+		glb.write(struct.pack("<4I", 0x46546C67, 2, 28 + len(gltf) + len(binary), len(gltf)) + struct.pack("<I", 0x4E4F534A) + gltf);
+		glb.write(struct.pack("<2I", len(binary), 0x004E4942) + bytes(binary));
+	mesh = gl.load_mesh(shaderID, glbPath);
+	assert (mesh["format"] == gl.POS_UV2D_NORMAL) and (mesh["vertices"] == 7) and (mesh["indices"] == 9), f"glTF mesh loaded wrong: {mesh}";
+	assert (tuple(mesh["bounds_min"]) == (0.0, 0.0, -1.0)) and (tuple(mesh["bounds_max"]) == (2.0, 3.0, 0.0)), "glTF mesh bounds are wrong";
+	assert gl.run(shaderID), "Failed to run Worldspace Shader with a loaded glTF mesh.";
+	gl.update_window();
+
+	#Optimising a grid built column by column must keep every triangle, and miss the vertex cache less.
+	grid:int = 32;
+	gridVertices:np.ndarray = np.array([(x, y, 0.0) for y in range(grid + 1) for x in range(grid + 1)], dtype=np.float32);
+	corners:list[int] = [y*(grid + 1) + x for x in range(grid) for y in range(grid)];
+	gridIndices:np.ndarray = np.array([(c, c + 1, c + grid + 2, c, c + grid + 2, c + grid + 1) for c in corners], dtype=np.uint32).ravel();
+	optimised:dict = gl.optimize_mesh(gl.POS_ONLY, gridVertices, gridIndices);
+	assert (optimised["indices"].size == gridIndices.size) and (optimised["vertices"].shape == gridVertices.shape), "Optimising changed the mesh's size";
+	assert (optimised["acmr_after"] < optimised["acmr_before"]), f"Optimising didn't help the vertex cache: {optimised['acmr_before']} -> {optimised['acmr_after']}";
+	#Same triangles & winding: each as its corner positions, rotated to start at the smallest corner, in sorted order.
+	def triangleSet(vertices:np.ndarray, indices:np.ndarray) -> list[tuple]:
+		corners:list[tuple] = [tuple(vertices[i].tolist()) for i in indices.ravel()];
+		triangles:list[tuple] = [tuple(corners[t:t + 3]) for t in range(0, len(corners), 3)];
+		return sorted(min(tri[r:] + tri[:r] for r in range(3)) for tri in triangles);
+	assert (triangleSet(optimised["vertices"].reshape(-1, 3), optimised["indices"]) == triangleSet(gridVertices, gridIndices)), "Optimising changed the mesh's triangles or their winding";
+	gl.add_vao(shaderID, gl.POS_ONLY, gridVertices.ravel(), gridIndices, optimize=True);
+
+	#Half-float/packed vertices draw the same, but positions must fit a half float, and indices the vertices given.
+	assert (gl.load_mesh(shaderID, objPath, packing=gl.PACK_COMPACT)["vertices"] == 8), "Packed mesh failed to load";
+	assert gl.run(shaderID), "Failed to run Worldspace Shader with packed vertices.";
+	gl.add_vao(shaderID, gl.POS_ONLY, gridVertices.ravel(), gridIndices, packing=gl.PACK_HALF);
+	for badVertices, badIndices in ((gridVertices.ravel() * 1e5, gridIndices), (gridVertices.ravel(), gridIndices + gridVertices.shape[0])):
+		try:
+			gl.add_vao(shaderID, gl.POS_ONLY, badVertices, badIndices, packing=gl.PACK_HALF);
+			raise AssertionError("Bad vertices were accepted");
+		except RuntimeError:
+			pass;
+	gl.add_vao(shaderID, gl.POS_ONLY, gridVertices.ravel(), gridIndices);
+
+	#Custom layouts: one structured buffer (with a colour the shader doesn't read), then positions & UVs in separate streams.
+	vertex:np.dtype = np.dtype([("position", "<f4", (3,)), ("uv", "<f4", (2,)), ("colour", "u1", (4,))]);
+	packed:np.ndarray = np.zeros(4, dtype=vertex);
+	packed["position"] = np.array(vertices, dtype=np.float32).reshape(-1, 5)[:, :3];
+	packed["uv"] = np.array(vertices, dtype=np.float32).reshape(-1, 5)[:, 3:];
+	gl.add_vao(shaderID, vertex, packed, indices);
+	assert gl.run(shaderID), "Failed to run Worldspace Shader with a structured vertex layout.";
+	gl.add_vao(shaderID, [(0, 3, "float32", False, 0, 0), (1, 2, "float16", False, 0, 1)], [packed["position"].copy(), packed["uv"].astype(np.float16)], indices);
+	assert gl.run(shaderID), "Failed to run Worldspace Shader with separate vertex streams.";
+	try:
+		gl.add_vao(shaderID, [(0, 3, "float32", False, 8)], packed["position"].copy(), indices); #Reads past each 12 byte vertex
+		raise AssertionError("Attribute outside its vertex was accepted");
+	except RuntimeError:
+		pass;
+	gl.add_vao(shaderID, gl.POS_UV2D, vertices, indices);
+
+	#Meshes of their own, drawn by the one shader.
+	meshIDs:list[int] = [gl.create_mesh(gl.POS_UV2D, vertices, indices, name="quad"), gl.create_mesh(vertex, packed, indices, name="structured")];
+	assert gl.draw(shaderID, meshIDs), "Failed to draw meshes with one shader.";
+	assert gl.run(shaderID, mesh=meshIDs[1]), "Failed to run Worldspace Shader over a mesh.";
+	gl.delete_mesh(meshIDs[0]);
+	try:
+		gl.draw(shaderID, meshIDs);
+		raise AssertionError("A deleted mesh was drawn");
+	except RuntimeError:
+		pass;
+	assert gl.run(shaderID), "Deleting a mesh broke the shader's own vertices.";
+	gl.update_window();
+
+	#Draw queue: alternating meshes, queued far to near, sort into 2 VAO switches instead of 8.
+	queueID:int = gl.create_draw_queue("test");
+	queuedTex:int = gl.load_texture("textures/a.png");
+	for i in range(8):
+		gl.queue_draw(queueID, shaderID, mesh=(meshIDs[1] if (i % 2) else -1), textures={0: queuedTex}, uniforms={"pvmMatrix": pvmMatrix}, depth=float(8 - i));
+	drawn:dict = gl.flush_draw_queue(queueID);
+	assert (drawn["draws"] == 8) and (drawn["meshes"] == 2) and (drawn["avoided"] == 6), f"Draw queue didn't sort its draws: {drawn}";
+	assert (gl.flush_draw_queue(queueID)["draws"] == 0), "Flushing didn't empty the draw queue";
+	#A draw without per-draw textures puts the shader's own back after one with them (back to front): 2 texture switches.
+	gl.queue_draw(queueID, shaderID, textures={0: queuedTex}, depth=2.0, transparent=True);
+	gl.queue_draw(queueID, shaderID, depth=1.0, transparent=True);
+	drawn = gl.flush_draw_queue(queueID);
+	assert (drawn["textures"] == 2), f"Per-draw textures weren't undone for the next draw: {drawn}";
+	try:
+		gl.queue_draw(queueID, shaderID, mesh=meshIDs[0]);
+		raise AssertionError("A deleted mesh was queued");
+	except RuntimeError:
+		pass;
+	gl.delete_draw_queue(queueID);
+	gl.update_window();
+
+
 	print(f"{Colours.SUCCESS}[PY ] Worldspace Shader Tests Passed{Colours.MINOR}");
 
 
@@ -254,6 +430,15 @@ def main() -> None:
 	gl.set_new_camera_fov(cameraID, fov_rad=1.57); #Using radians
 	gl.set_new_camera_clip(cameraID, z_near=0.01, z_far=10.0);
 
+	#The cached combined matrix must match multiplying the two out.
+	camMats:dict = gl.get_camera_matrices(cameraID);
+	combined:glm.mat4 = glm.mat4(gl.get_matrix(gl.PERSPECTIVE, cameraID)) * glm.mat4(gl.get_matrix(gl.VIEW, cameraID));
+	assert all(abs(camMats["view_projection"][c][r] - combined[c][r]) < 1e-5 for c in range(4) for r in range(4)), "Cached view-projection is stale";
+
+	#Cull one sphere in front (+Y) and one behind the camera.
+	spheres:np.ndarray = np.array([[0.0, 5.0, 0.0, 1.0], [0.0, -5.0, 0.0, 1.0]], dtype=np.float32);
+	assert (list(gl.cull(cameraID, spheres)) == [0]), "Frustum culling kept the wrong spheres";
+
 
 
 	#Test loading a texture & creating an image;
@@ -265,6 +450,22 @@ def main() -> None:
 	i2D:int = gl.create_texture(glm.ivec2(128, 128));
 	assert (i2D != -1), "Failed to create image2D";
 
+	print(f"{Colours.MAJOR}[PY ] Testing texture pairs{Colours.MINOR}");
+	i2Dback:int = gl.create_texture(glm.ivec2(128, 128));
+	pairID:int = gl.create_texture_pair(i2D, i2Dback);
+	assert (pairID != -1), "Failed to create texture pair";
+	gl.swap(pairID);
+	pairShader:int = gl.load_shader(gl.COMPUTE, compute="shaders/compute.comp");
+	gl.add_texture_pair(pairShader, pairID, 0);
+	assert gl.run(pairShader, [1, 1, 1]), "Failed to run a shader bound to a texture pair.";
+	gl.delete_texture_pair(pairID);
+	assert gl.run(pairShader, [1, 1, 1]), "A shader bound to a deleted texture pair failed to run.";
+	try:
+		gl.swap(pairID);
+		raise AssertionError("A deleted texture pair was swapped");
+	except RuntimeError:
+		pass;
+
 	print(f"{Colours.MAJOR}[PY ] Testing texture saving to file{Colours.MINOR}");
 	gl.save_texture(s2D, "textures/test.out.png"); #Save the image2D to a file.
 
@@ -282,9 +483,22 @@ def main() -> None:
 	#Trying to delete the camera.
 	gl.delete_camera(cameraID);
 
+	#Anything the driver complained about during the tests.
+	for message in gl.get_debug_messages():
+		print(f"{Colours.VALUE}[PY ] GL debug [{message['severity']}] x{message['count']}: {message['message']}{Colours.MINOR}");
+
+	print(f"{Colours.MAJOR}[PY ] Testing log sinks{Colours.MINOR}");
+	logPath:str = os.path.join(outputs.name, "test.out.log");
+	gl.set_log_sink(gl.LOG_FILE, logPath);
+	gl.set_barrier_mode(gl.BARRIER_TRACKED); #Anything that logs.
+	gl.flush_log();
+	with open(logPath) as log: assert ("barrier mode" in log.read()), "Log message never reached the file sink";
+	gl.set_log_sink(gl.LOG_STDOUT);
+
 	print(f"{Colours.SUCCESS}[PY ] Success : All tests pass.{Colours.MINOR}");
 
 	gl.terminate(); #Test shutdown
+	outputs.cleanup();
 	print(f"{Colours.WARNING}[PY ] Module testing terminated {Colours.DEFAULT}");
 	
 